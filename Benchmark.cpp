@@ -0,0 +1,313 @@
+// Benchmark.cpp
+// 调度器性能基准：在不同规模的合成负载上对各调度算法计时，结果以JSON输出
+// 不显示甘特图窗口，不输出调度日志，可在无图形界面的Linux上运行。
+//
+// 用法：benchmark [--min N] [--max N] [--policies 1,2,...]
+//                 [--load steady,overload,batch] [--io off,on,heavy,multi]
+//                 [--seed S] [--no-fork] [--output 文件]
+//                 [--cpus N] [--per-cpu] [--balance T] [--steal]
+// Linux下每个用例在子进程中运行，峰值内存（RSS）只统计该用例。
+#include "stdafx.h"
+#include "ProcessSchedulingSimulator.h"
+#include "WorkloadGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// 统计全局operator new的调用次数
+static atomic<long long> g_allocations(0);
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p) throw bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+namespace {
+
+const char* kPolicyNames[] = { "", "FCFS", "RoundRobin", "DynamicPriority", "SJF", "HRRN", "SRTF", "MLFQ", "CFS" };
+
+// 负载强度：steady约0.8的CPU利用率；overload到达率为服务能力的4倍，就绪队列增长到进程数的量级；
+// batch全部进程在0时刻到达
+enum LoadMode { LoadSteady, LoadOverload, LoadBatch };
+const char* kLoadNames[] = { "steady", "overload", "batch" };
+
+// IO：off无IO；on为30%的进程带一次平均5个时间单位的IO；heavy为每个进程都带一次平均20个时间单位的IO；
+// multi为每个进程都带8次平均5个时间单位的IO（CPU和IO交替多次）
+enum IoMode { IoOff, IoOn, IoHeavy, IoMulti };
+const char* kIoNames[] = { "off", "on", "heavy", "multi" };
+
+struct BenchOptions {
+    size_t min_processes;
+    size_t max_processes;
+    vector<int> policies;
+    vector<int> loads;
+    vector<int> io_modes;
+    uint64_t seed;
+    bool fork_cases;
+    string output;
+    int cpus;
+    bool per_cpu;
+    int balance;
+    bool steal;
+
+    BenchOptions()
+        : min_processes(1000), max_processes(10000000), policies({ 1, 2, 3, 4, 5, 6, 7, 8 }),
+          loads({ LoadSteady, LoadOverload, LoadBatch }), io_modes({ IoOff, IoOn, IoHeavy }), seed(1), fork_cases(true), cpus(1), per_cpu(false), balance(0), steal(false) {}
+};
+
+struct BenchCase {
+    int policy;
+    size_t processes;
+    int load;
+    int io;
+    const BenchOptions* options;
+};
+
+struct BenchResult {
+    double generate_seconds;
+    double wall_seconds;
+    long long events;          // 完整处理的调度轮次
+    long long simulated_time;
+    long long finished;
+    long long allocations;     // 模拟期间的堆分配次数
+    long long peak_rss_kb;     // 不支持时为-1
+    bool valid;                // 负载总时长超出int范围时为false，不模拟
+};
+
+double Seconds(chrono::steady_clock::time_point since) {
+    return chrono::duration<double>(chrono::steady_clock::now() - since).count();
+}
+
+long long PeakRssKb() {
+#ifdef __linux__
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) return usage.ru_maxrss;
+#endif
+    return -1;
+}
+
+// 平均服务时间为4：steady约80%负载，overload到达速度为处理能力的4倍，batch全部在0时刻到达；到达率随CPU数增加
+GeneratorConfig WorkloadFor(const BenchCase& c, uint64_t seed) {
+    static const double kRates[] = { 0.2, 1.0, 1e12 };
+    GeneratorConfig config;
+    config.count = c.processes;
+    config.seed = seed;
+    config.arrival_rate = kRates[c.load] * c.options->cpus;
+    config.service_mean = 4;
+    config.io_probability = c.io == IoOff ? 0 : c.io == IoOn ? 0.3 : 1.0;
+    config.io_mean = c.io == IoHeavy ? 20 : 5;
+    config.io_bursts = c.io == IoMulti ? 8 : 1;
+    return config;
+}
+
+// 解析逗号分隔的名称列表，名称在names中的下标存入out
+bool ParseNames(const char* value, const char* const* names, int count, vector<int>& out) {
+    out.clear();
+    string list = value;
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        size_t comma = list.find(',', pos);
+        if (comma == string::npos) comma = list.size();
+        string name = list.substr(pos, comma - pos);
+        int index = (int)(find(names, names + count, name) - names);
+        if (index == count) return false;
+        out.push_back(index);
+        pos = comma + 1;
+    }
+    return true;
+}
+
+BenchResult RunCase(const BenchCase& c, uint64_t seed) {
+    BenchResult result;
+    ProcessScheduler scheduler;
+    scheduler.quiet = true;
+    scheduler.ConfigureCpus(c.options->cpus, c.options->per_cpu, c.options->balance, c.options->steal);
+
+    auto start = chrono::steady_clock::now();
+    wstring error;
+    result.valid = WorkloadGenerator(WorkloadFor(c, seed)).Generate(scheduler.pcb_pool, scheduler.burst_arena, error);
+    if (!result.valid) return result;
+    for (size_t i = 0; i < scheduler.pcb_pool.size(); i++)
+        scheduler.InitProcess(scheduler.pcb_pool[i], (int)i + 1);
+    scheduler.BuildArriveQueue(true);
+    result.generate_seconds = Seconds(start);
+    result.valid = scheduler.CheckTimeRange(error);
+    if (!result.valid) return result;
+
+    long long allocations = g_allocations.load();
+    start = chrono::steady_clock::now();
+    scheduler.Simulate((SchedulePolicy)c.policy);
+    result.wall_seconds = Seconds(start);
+    result.allocations = g_allocations.load() - allocations;
+
+    result.events = scheduler.step_count;
+    result.simulated_time = scheduler.current_time;
+    result.finished = (long long)scheduler.finish_queue.size();
+    result.peak_rss_kb = PeakRssKb();
+    return result;
+}
+
+// 在子进程中运行用例，通过管道取回结果
+bool RunCaseIsolated(const BenchCase& c, uint64_t seed, BenchResult& result) {
+#ifdef __linux__
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    fflush(nullptr);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        BenchResult r = RunCase(c, seed);
+        ssize_t written = write(fds[1], &r, sizeof(r));
+        _exit(written == (ssize_t)sizeof(r) ? 0 : 1);
+    }
+    close(fds[1]);
+    ssize_t got = read(fds[0], &result, sizeof(result));
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return got == (ssize_t)sizeof(result) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#else
+    result = RunCase(c, seed);
+    return true;
+#endif
+}
+
+void WriteResult(FILE* out, const BenchCase& c, const BenchResult& r, bool first) {
+    double events_per_second = r.wall_seconds > 0 ? r.events / r.wall_seconds : 0;
+    double processes_per_second = r.wall_seconds > 0 ? c.processes / r.wall_seconds : 0;
+    fprintf(out,
+        "%s\n    {\"policy\": \"%s\", \"processes\": %zu, \"load\": \"%s\", \"io\": \"%s\", \"cpus\": %d, "
+        "\"events\": %lld, \"simulated_time\": %lld, \"finished\": %lld, "
+        "\"generate_seconds\": %.6f, \"wall_seconds\": %.6f, "
+        "\"events_per_second\": %.1f, \"processes_per_second\": %.1f, "
+        "\"peak_rss_kb\": %lld, \"allocations\": %lld, \"allocations_per_process\": %.4f}",
+        first ? "" : ",", kPolicyNames[c.policy], c.processes, kLoadNames[c.load], kIoNames[c.io], c.options->cpus,
+        r.events, r.simulated_time, r.finished,
+        r.generate_seconds, r.wall_seconds,
+        events_per_second, processes_per_second,
+        r.peak_rss_kb, r.allocations, c.processes ? (double)r.allocations / c.processes : 0.0);
+    fflush(out);
+}
+
+bool ParseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--no-fork") {
+            options.fork_cases = false;
+            continue;
+        }
+        if (arg == "--per-cpu" || arg == "--steal") {
+            (arg == "--per-cpu" ? options.per_cpu : options.steal) = true;
+            continue;
+        }
+        if (!value) return false;
+        i++;
+        if (arg == "--min") {
+            options.min_processes = strtoull(value, nullptr, 10);
+        } else if (arg == "--max") {
+            options.max_processes = strtoull(value, nullptr, 10);
+        } else if (arg == "--seed") {
+            options.seed = strtoull(value, nullptr, 10);
+        } else if (arg == "--cpus") {
+            options.cpus = atoi(value);
+            if (options.cpus < 1 || options.cpus > kMaxCpus) return false;
+        } else if (arg == "--balance") {
+            options.balance = atoi(value);
+            if (options.balance < 0) return false;
+        } else if (arg == "--output") {
+            options.output = value;
+        } else if (arg == "--io") {
+            if (!ParseNames(value, kIoNames, 4, options.io_modes)) return false;
+        } else if (arg == "--load") {
+            if (!ParseNames(value, kLoadNames, 3, options.loads)) return false;
+        } else if (arg == "--policies") {
+            options.policies.clear();
+            for (const char* p = value; *p; ) {
+                int policy = (int)strtol(p, (char**)&p, 10);
+                if (policy < PolicyFCFS || policy > kLastPolicy) return false;
+                options.policies.push_back(policy);
+                if (*p == ',') p++;
+                else if (*p) return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return options.min_processes > 0 && options.min_processes <= options.max_processes;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        fprintf(stderr, "usage: benchmark [--min N] [--max N] [--policies 1,2,...] "
+            "[--load steady,overload,batch] [--io off,on,heavy,multi]\n"
+            "                 [--seed S] [--no-fork] [--output FILE]\n"
+            "                 [--cpus N] [--per-cpu] [--balance T] [--steal]\n");
+        return EXIT_FAILURE;
+    }
+
+    FILE* out = stdout;
+    if (!options.output.empty()) {
+        out = fopen(options.output.c_str(), "w");
+        if (!out) {
+            fprintf(stderr, "cannot open %s\n", options.output.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    fprintf(out, "{\n  \"benchmark\": \"ProcessSchedulingSimulator\",\n  \"seed\": %llu,\n  \"results\": [",
+        (unsigned long long)options.seed);
+    bool first = true;
+    int failures = 0;
+    for (size_t n = options.min_processes; n <= options.max_processes; n *= 10) {
+        for (int load : options.loads) {
+            for (int io : options.io_modes) {
+                for (int policy : options.policies) {
+                    BenchCase c = { policy, n, load, io, &options };
+                    BenchResult r;
+                    bool ok = options.fork_cases ? RunCaseIsolated(c, options.seed, r) : (r = RunCase(c, options.seed), true);
+                    if (!ok || !r.valid) {
+                        fprintf(stderr, "case %s n=%zu load=%s io=%s failed\n",
+                            kPolicyNames[policy], n, kLoadNames[load], kIoNames[io]);
+                        failures++;
+                        continue;
+                    }
+                    WriteResult(out, c, r, first);
+                    first = false;
+                    fprintf(stderr, "%-16s n=%-9zu %-8s io=%-5s %.3fs\n",
+                        kPolicyNames[policy], n, kLoadNames[load], kIoNames[io], r.wall_seconds);
+                }
+            }
+        }
+        if (n > options.max_processes / 10) break;
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) fclose(out);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,435 @@
+#include "stdafx.h"
+#include "BinaryFormat.h"
+#include "WorkloadLoader.h"
+#include "WorkloadGenerator.h"
+#include "Utf8.h"
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+const size_t kWriteBuffer = 1 << 20;
+
+inline uint64_t Align8(uint64_t n) { return (n + 7) & ~(uint64_t)7; }
+
+wstring Widen(const string& s) { return wstring(s.begin(), s.end()); }
+
+// 顺序写文件，记录已写字节数并可补齐到8字节边界
+class FileWriter {
+public:
+    FileWriter() : m_fp(nullptr), m_pos(0), m_ok(true) {}
+    ~FileWriter() { if (m_fp) fclose(m_fp); }
+
+    bool Open(const string& path) {
+        m_fp = fopen(path.c_str(), "wb");
+        if (m_fp) setvbuf(m_fp, nullptr, _IOFBF, kWriteBuffer);
+        return m_fp != nullptr;
+    }
+
+    void Write(const void* data, size_t size) {
+        if (size && fwrite(data, 1, size, m_fp) != size) m_ok = false;
+        m_pos += size;
+    }
+
+    void Pad() {
+        static const char zeros[8] = { 0 };
+        Write(zeros, (size_t)(Align8(m_pos) - m_pos));
+    }
+
+    // 关闭文件，返回全部写入是否成功
+    bool Close() {
+        if (fclose(m_fp) != 0) m_ok = false;
+        m_fp = nullptr;
+        return m_ok;
+    }
+
+private:
+    FILE* m_fp;
+    uint64_t m_pos;
+    bool m_ok;
+};
+
+// 进程名字符串表
+class StringTable {
+public:
+    // 加入一个名字，返回false表示字符串表超过4GB
+    bool Add(const wstring& name, uint32_t& offset, uint32_t& length) {
+        size_t start = m_data.size();
+        EncodeUtf8(name, m_data);
+        if (m_data.size() > UINT32_MAX) return false;
+        offset = (uint32_t)start;
+        length = (uint32_t)(m_data.size() - start);
+        return true;
+    }
+
+    const string& Data() const { return m_data; }
+
+private:
+    string m_data;
+};
+
+// 按各区大小填好文件头
+void LayoutHeader(BinaryHeader& header, uint64_t records, uint64_t segments, uint64_t bursts, uint64_t strings) {
+    uint64_t pos = sizeof(BinaryHeader);
+    header.records.offset = pos;
+    header.records.count = records;
+    pos = Align8(pos + records * header.record_size);
+    header.segments.offset = pos;
+    header.segments.count = segments;
+    pos = Align8(pos + segments * header.segment_size);
+    header.bursts.offset = pos;
+    header.bursts.count = bursts;
+    pos = Align8(pos + bursts * sizeof(IoBurst));
+    header.strings.offset = pos;
+    header.strings.count = strings;
+}
+
+BinaryHeader NewHeader(BinaryKind kind, uint32_t record_size) {
+    BinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = kBinaryMagic;
+    header.version = kBinaryVersion;
+    header.kind = (uint16_t)kind;
+    header.record_size = record_size;
+    header.segment_size = sizeof(SegmentRecord);
+    return header;
+}
+
+// 进程的CPU/IO交替时长"CPU:IO:CPU:...:CPU"（WorkloadLoader第7列的格式）
+string BurstList(const ProcessPCB& pro, const vector<IoBurst>& bursts) {
+    string list;
+    int done = 0;  // 已列出的CPU时长之和
+    for (uint32_t i = 0; i <= pro.burst_count; i++) {
+        IoBurst io = i == 0 ? IoBurst{ pro.io_start, pro.io_time } : bursts[pro.burst_offset + i - 1];
+        if (io.time <= 0 || io.start < done || io.start >= pro.service_time) break;
+        list += to_string(io.start - done) + ":" + to_string(io.time) + ":";
+        done = io.start;
+    }
+    return list + to_string(pro.service_time - done);
+}
+
+// CSV字段中需要加引号的进程名
+bool NeedsQuote(const string& name) {
+    if (name.empty()) return false;
+    if (name[0] == ' ' || name[0] == '#' || name[name.size() - 1] == ' ') return true;
+    return name.find_first_of(",\"\t\r\n") != string::npos;
+}
+
+} // namespace
+
+BinaryReader::BinaryReader() : m_header(nullptr) {}
+
+bool BinaryReader::Fail(const wstring& msg) {
+    m_error = msg;
+    m_header = nullptr;
+    m_file.Close();
+    return false;
+}
+
+bool BinaryReader::CheckSection(const BinarySection& section, size_t item_size) const {
+    if (section.offset % 8 != 0 || section.offset > m_file.Size()) return false;
+    if (item_size == 0) return section.count == 0;
+    return section.count <= (m_file.Size() - section.offset) / item_size;
+}
+
+bool BinaryReader::Open(const string& path, BinaryKind kind) {
+    m_error.clear();
+    if (!m_file.Open(path)) return Fail(L"无法打开文件：" + Widen(path));
+    if (m_file.Size() < sizeof(BinaryHeader)) return Fail(L"文件过短，不是有效的二进制文件");
+
+    const BinaryHeader* header = (const BinaryHeader*)m_file.Data();
+    if (header->magic != kBinaryMagic) return Fail(L"文件标识不匹配");
+    if (header->version != kBinaryVersion)
+        return Fail(L"不支持的文件版本" + to_wstring(header->version));
+    if (header->kind != kind)
+        return Fail(kind == BinaryWorkload ? L"文件不是负载文件" : L"文件不是结果文件");
+
+    size_t record_size = kind == BinaryWorkload ? sizeof(WorkloadRecord) : sizeof(ResultRecord);
+    if (header->record_size != record_size || header->segment_size != sizeof(SegmentRecord))
+        return Fail(L"记录长度与当前版本不一致");
+
+    m_header = header;
+    if (!CheckSection(header->records, record_size) ||
+        !CheckSection(header->segments, sizeof(SegmentRecord)) ||
+        !CheckSection(header->bursts, sizeof(IoBurst)) ||
+        !CheckSection(header->strings, 1))
+        return Fail(L"文件已截断或区段越界");
+    return true;
+}
+
+void BinaryReader::Name(uint32_t offset, uint32_t length, wstring& out) const {
+    if ((uint64_t)offset + length > m_header->strings.count) {
+        out.clear();
+        return;
+    }
+    const char* p = Section(m_header->strings) + offset;
+    DecodeUtf8(p, p + length, out);
+}
+
+bool IsBinaryFile(const string& path) {
+    if (path == "-") return false;
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) return false;
+    uint32_t magic = 0;
+    bool binary = fread(&magic, sizeof(magic), 1, fp) == 1 && magic == kBinaryMagic;
+    fclose(fp);
+    return binary;
+}
+
+bool SaveWorkloadBinary(const string& path, const vector<ProcessPCB>& processes, const vector<IoBurst>& bursts,
+    wstring& error) {
+    StringTable names;
+    vector<WorkloadRecord> records(processes.size());
+    vector<IoBurst> packed;  // 按记录顺序重新排列的IO
+    BinaryHeader header = NewHeader(BinaryWorkload, sizeof(WorkloadRecord));
+    header.flags = kBinarySortedByArrive;
+    for (size_t i = 0; i < processes.size(); i++) {
+        const ProcessPCB& pro = processes[i];
+        WorkloadRecord& rec = records[i];
+        rec.id = pro.ID;
+        rec.arrive_time = pro.arrive_time;
+        rec.service_time = pro.service_time;
+        rec.priority = pro.priority;
+        rec.io_start = pro.io_start;
+        rec.io_time = pro.io_time;
+        rec.burst_offset = (uint32_t)packed.size();
+        rec.burst_count = pro.burst_count;
+        packed.insert(packed.end(), bursts.begin() + pro.burst_offset,
+            bursts.begin() + pro.burst_offset + pro.burst_count);
+        if (!names.Add(pro.name, rec.name_offset, rec.name_length)) {
+            error = L"进程名总长度超过4GB";
+            return false;
+        }
+        if (i > 0 && pro.arrive_time < processes[i - 1].arrive_time) header.flags &= ~kBinarySortedByArrive;
+    }
+    if (packed.size() > UINT32_MAX) {
+        error = L"IO总次数超出范围";
+        return false;
+    }
+    LayoutHeader(header, records.size(), 0, packed.size(), names.Data().size());
+
+    FileWriter out;
+    if (!out.Open(path)) {
+        error = L"无法创建文件：" + Widen(path);
+        return false;
+    }
+    out.Write(&header, sizeof(header));
+    out.Write(records.data(), records.size() * sizeof(WorkloadRecord));
+    out.Pad();
+    out.Write(packed.data(), packed.size() * sizeof(IoBurst));
+    out.Pad();
+    out.Write(names.Data().data(), names.Data().size());
+    if (!out.Close()) {
+        error = L"写入文件失败：" + Widen(path);
+        return false;
+    }
+    return true;
+}
+
+bool CheckProcessIds(vector<int32_t>& ids, wstring& error) {
+    sort(ids.begin(), ids.end());
+    if (!ids.empty() && ids.front() <= 0) {
+        error = L"进程ID必须为正数：" + to_wstring(ids.front());
+        return false;
+    }
+    auto dup = adjacent_find(ids.begin(), ids.end());
+    if (dup != ids.end()) {
+        error = L"进程ID重复：" + to_wstring(*dup);
+        return false;
+    }
+    return true;
+}
+
+bool LoadWorkloadBinary(const string& path, vector<ProcessPCB>& processes, vector<IoBurst>& bursts, bool& sorted,
+    wstring& error) {
+    BinaryReader reader;
+    if (!reader.Open(path, BinaryWorkload)) {
+        error = reader.Error();
+        return false;
+    }
+    const WorkloadRecord* records = reader.Workload();
+    size_t count = reader.Count();
+    sorted = (reader.Header().flags & kBinarySortedByArrive) != 0;
+
+    vector<int32_t> ids(count);
+    for (size_t i = 0; i < count; i++) ids[i] = records[i].id;
+    if (!CheckProcessIds(ids, error)) return false;
+
+    // IO区整体追加，记录中的偏移加上原有的IO数
+    const IoBurst* io = reader.Bursts();
+    size_t base = bursts.size();
+    if (base + reader.BurstCount() > UINT32_MAX) {
+        error = L"IO总次数超出范围";
+        return false;
+    }
+    for (size_t i = 0; i < reader.BurstCount(); i++) {
+        if (io[i].start < 0 || io[i].time <= 0) {
+            error = L"第" + to_wstring(i + 1) + L"条IO记录无效";
+            return false;
+        }
+    }
+
+    processes.reserve(processes.size() + count);
+    for (size_t i = 0; i < count; i++) {
+        const WorkloadRecord& rec = records[i];
+        if (rec.arrive_time < 0 || rec.service_time <= 0 || rec.io_time < 0 ||
+            rec.arrive_time > INT32_MAX - rec.service_time) {
+            error = L"第" + to_wstring(i + 1) + L"条记录的时间字段无效";
+            return false;
+        }
+        // 后续IO必须在第一次IO之后且按开始位置排列
+        bool bursts_ok = (uint64_t)rec.burst_offset + rec.burst_count <= reader.BurstCount() &&
+            (rec.burst_count == 0 || (rec.io_start >= 0 && rec.io_time > 0));
+        for (uint32_t k = 0; k < rec.burst_count && bursts_ok; k++) {
+            int32_t previous = k == 0 ? rec.io_start : io[rec.burst_offset + k - 1].start;
+            bursts_ok = io[rec.burst_offset + k].start >= previous;
+        }
+        if (!bursts_ok) {
+            error = L"第" + to_wstring(i + 1) + L"条记录的IO字段无效";
+            return false;
+        }
+        ProcessPCB pro;
+        pro.ID = rec.id;
+        pro.arrive_time = rec.arrive_time;
+        pro.service_time = rec.service_time;
+        pro.priority = rec.priority;
+        pro.io_start = rec.io_start;
+        pro.io_time = rec.io_time;
+        pro.burst_offset = (uint32_t)base + rec.burst_offset;
+        pro.burst_count = rec.burst_count;
+        reader.Name(rec.name_offset, rec.name_length, pro.name);
+        processes.push_back(std::move(pro));
+    }
+    bursts.insert(bursts.end(), io, io + reader.BurstCount());
+    return true;
+}
+
+bool SaveResultsBinary(const string& path, const vector<ProcessPCB>& pool,
+    const vector<PcbHandle>& finished, const vector<Timeline>& lanes, wstring& error) {
+    StringTable names;
+    vector<ResultRecord> records(finished.size());
+    for (size_t i = 0; i < finished.size(); i++) {
+        const ProcessPCB& pro = pool[finished[i]];
+        ResultRecord& rec = records[i];
+        rec.id = pro.ID;
+        rec.arrive_time = pro.arrive_time;
+        rec.service_time = pro.service_time;
+        rec.priority = pro.priority;
+        rec.io_start = pro.io_start;
+        rec.io_time = pro.io_time;
+        rec.start_time = pro.start_time;
+        rec.end_time = pro.end_time;
+        rec.wait_time = pro.wait_time;
+        rec.response_time = pro.response_time;
+        rec.turnaround_time = pro.turnaround_time;
+        rec.io_count = pro.io_count;
+        if (!names.Add(pro.name, rec.name_offset, rec.name_length)) {
+            error = L"进程名总长度超过4GB";
+            return false;
+        }
+    }
+
+    size_t segment_count = 0;
+    for (const Timeline& lane : lanes) segment_count += lane.Segments().size();
+    BinaryHeader header = NewHeader(BinaryResults, sizeof(ResultRecord));
+    LayoutHeader(header, records.size(), segment_count, 0, names.Data().size());
+
+    FileWriter out;
+    if (!out.Open(path)) {
+        error = L"无法创建文件：" + Widen(path);
+        return false;
+    }
+    out.Write(&header, sizeof(header));
+    out.Write(records.data(), records.size() * sizeof(ResultRecord));
+    out.Pad();
+    for (size_t cpu = 0; cpu < lanes.size(); cpu++) {
+        for (const TimelineSegment& seg : lanes[cpu].Segments()) {
+            SegmentRecord rec = { seg.pid, (int32_t)cpu, seg.start, seg.end };
+            out.Write(&rec, sizeof(rec));
+        }
+    }
+    out.Pad();
+    out.Write(names.Data().data(), names.Data().size());
+    if (!out.Close()) {
+        error = L"写入文件失败：" + Widen(path);
+        return false;
+    }
+    return true;
+}
+
+bool SaveWorkloadText(const string& path, const vector<ProcessPCB>& processes, const vector<IoBurst>& bursts,
+    wstring& error) {
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp) {
+        error = L"无法创建文件：" + Widen(path);
+        return false;
+    }
+    setvbuf(fp, nullptr, _IOFBF, kWriteBuffer);
+    // 只有一次IO的负载仍写6列，与旧版本兼容
+    bool lists = any_of(processes.begin(), processes.end(),
+        [](const ProcessPCB& pro) { return pro.burst_count > 0; });
+    fputs("name,arrive,service,priority,io_start,io_time", fp);
+    fputs(lists ? ",bursts\n" : "\n", fp);
+
+    string name;
+    for (const ProcessPCB& pro : processes) {
+        name.clear();
+        EncodeUtf8(pro.name, name);
+        if (NeedsQuote(name)) {
+            string quoted = "\"";
+            for (char c : name) {
+                if (c == '"') quoted.push_back('"');
+                quoted.push_back(c);
+            }
+            quoted.push_back('"');
+            name.swap(quoted);
+        }
+        fprintf(fp, "%s,%d,%d,%d,%d,%d", name.c_str(), pro.arrive_time, pro.service_time,
+            pro.priority, pro.io_start, pro.io_time);
+        if (lists) fprintf(fp, ",%s", BurstList(pro, bursts).c_str());
+        fputc('\n', fp);
+    }
+    bool ok = !ferror(fp);
+    if (fclose(fp) != 0) ok = false;
+    if (!ok) error = L"写入文件失败：" + Widen(path);
+    return ok;
+}
+
+// 输出文件名的扩展名是否为文本格式
+static bool IsTextPath(const string& path) {
+    size_t dot = path.rfind('.');
+    if (dot == string::npos) return false;
+    string ext = path.substr(dot);
+    return ext == ".csv" || ext == ".tsv" || ext == ".txt";
+}
+
+bool ConvertWorkload(const string& input, const string& output, wstring& error) {
+    vector<ProcessPCB> processes;
+    vector<IoBurst> bursts;
+    if (WorkloadGenerator::IsSpec(input)) {
+        // 合成负载按输出文件的扩展名选择格式
+        GeneratorConfig config;
+        if (!WorkloadGenerator::ParseSpec(input, config, error)) return false;
+        if (!WorkloadGenerator(config).Generate(processes, bursts, error)) return false;
+        for (size_t i = 0; i < processes.size(); i++) processes[i].ID = (int)i + 1;
+        if (IsTextPath(output)) return SaveWorkloadText(output, processes, bursts, error);
+        return SaveWorkloadBinary(output, processes, bursts, error);
+    }
+    if (IsBinaryFile(input)) {
+        bool sorted;
+        if (!LoadWorkloadBinary(input, processes, bursts, sorted, error)) return false;
+        return SaveWorkloadText(output, processes, bursts, error);
+    }
+
+    WorkloadLoader loader;
+    if (!loader.LoadFile(input, processes, bursts)) {
+        error = loader.Error();
+        return false;
+    }
+    for (size_t i = 0; i < processes.size(); i++) processes[i].ID = (int)i + 1;
+    return SaveWorkloadBinary(output, processes, bursts, error);
+}
@@ -0,0 +1,126 @@
+// BinaryFormat.h
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "ProcessSchedulingSimulator.h"
+#include "MappedFile.h"
+
+// 二进制负载/结果文件（小端、定长记录）
+// 文件头之后依次是记录区、甘特图段区、IO区和字符串表，各区起点按8字节对齐。
+// 进程名以UTF-8存放在字符串表中，第二次及以后的IO存放在IO区中，记录里只保存偏移和长度，
+// 因此读取时直接映射文件按结构体访问，不需要逐字段解析。
+const uint32_t kBinaryMagic = 0x42535350;  // "PSSB"
+const uint16_t kBinaryVersion = 2;         // 版本2增加了IO区
+
+enum BinaryKind {
+    BinaryWorkload = 1,  // 负载：WorkloadRecord
+    BinaryResults = 2    // 模拟结果：ResultRecord（完成顺序）+ 甘特图段
+};
+
+// 文件头标志位
+const uint32_t kBinarySortedByArrive = 1;  // 记录已按到达时间非递减排列
+
+struct BinarySection {
+    uint64_t offset;  // 距文件开头的字节数
+    uint64_t count;   // 记录条数（字符串表为字节数）
+};
+
+struct BinaryHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t kind;
+    uint32_t flags;
+    uint32_t record_size;   // 记录区每条记录的字节数
+    uint32_t segment_size;  // 甘特图段每条的字节数
+    uint32_t reserved;
+    BinarySection records;
+    BinarySection segments;
+    BinarySection strings;
+    BinarySection bursts;   // IoBurst记录（结果文件中为空）
+};
+
+struct WorkloadRecord {
+    int32_t id;
+    int32_t arrive_time, service_time, priority;
+    int32_t io_start, io_time;
+    uint32_t name_offset, name_length;
+    uint32_t burst_offset, burst_count;  // 第二次及以后的IO在IO区中的位置
+};
+
+struct ResultRecord {
+    int32_t id;
+    int32_t arrive_time, service_time, priority;
+    int32_t io_start, io_time;
+    int32_t start_time, end_time, wait_time, response_time, turnaround_time, io_count;
+    uint32_t name_offset, name_length;
+};
+
+struct SegmentRecord {
+    int32_t pid;
+    int32_t cpu;       // 所在CPU的泳道
+    int64_t start, end;
+};
+
+static_assert(sizeof(BinaryHeader) == 88, "BinaryHeader layout");
+static_assert(sizeof(WorkloadRecord) == 40, "WorkloadRecord layout");
+static_assert(sizeof(IoBurst) == 8, "IoBurst layout");
+static_assert(sizeof(ResultRecord) == 56, "ResultRecord layout");
+static_assert(sizeof(SegmentRecord) == 24, "SegmentRecord layout");
+
+// 映射二进制文件并校验文件头，之后按结构体数组直接访问各区
+class BinaryReader {
+public:
+    BinaryReader();
+
+    bool Open(const std::string& path, BinaryKind kind);
+
+    const BinaryHeader& Header() const { return *m_header; }
+    size_t Count() const { return (size_t)m_header->records.count; }
+    const WorkloadRecord* Workload() const { return (const WorkloadRecord*)Section(m_header->records); }
+    const ResultRecord* Results() const { return (const ResultRecord*)Section(m_header->records); }
+    size_t SegmentCount() const { return (size_t)m_header->segments.count; }
+    const SegmentRecord* Segments() const { return (const SegmentRecord*)Section(m_header->segments); }
+    size_t BurstCount() const { return (size_t)m_header->bursts.count; }
+    const IoBurst* Bursts() const { return (const IoBurst*)Section(m_header->bursts); }
+
+    // 取字符串表中的进程名，越界时返回空串
+    void Name(uint32_t offset, uint32_t length, std::wstring& out) const;
+
+    const std::wstring& Error() const { return m_error; }
+
+private:
+    const char* Section(const BinarySection& section) const { return m_file.Data() + section.offset; }
+    bool CheckSection(const BinarySection& section, size_t item_size) const;
+    bool Fail(const std::wstring& msg);
+
+    MappedFile m_file;
+    const BinaryHeader* m_header;
+    std::wstring m_error;
+};
+
+// 文件开头是否为二进制格式的标识
+bool IsBinaryFile(const std::string& path);
+
+// 保存负载（只写入输入字段），bursts为进程的burst_offset所指的IO数组
+bool SaveWorkloadBinary(const std::string& path, const std::vector<ProcessPCB>& processes,
+    const std::vector<IoBurst>& bursts, std::wstring& error);
+
+// 进程ID必须为正且互不相同（ID决定甘特图中的行，-1表示空闲），ids会被排序
+bool CheckProcessIds(std::vector<int32_t>& ids, std::wstring& error);
+
+// 读取二进制负载，追加到processes，第二次及以后的IO追加到bursts；sorted返回是否已按到达时间排列
+bool LoadWorkloadBinary(const std::string& path, std::vector<ProcessPCB>& processes,
+    std::vector<IoBurst>& bursts, bool& sorted, std::wstring& error);
+
+// 保存模拟结果：按完成顺序的进程记录和各CPU的甘特图段（按CPU依次存放）
+bool SaveResultsBinary(const std::string& path, const std::vector<ProcessPCB>& pool,
+    const std::vector<PcbHandle>& finished, const std::vector<Timeline>& lanes, std::wstring& error);
+
+// 以CSV文本格式保存负载（可被WorkloadLoader读回），有进程带多次IO时增加CPU/IO交替时长列
+bool SaveWorkloadText(const std::string& path, const std::vector<ProcessPCB>& processes,
+    const std::vector<IoBurst>& bursts, std::wstring& error);
+
+// 文本与二进制负载互转，方向由输入文件的格式决定
+bool ConvertWorkload(const std::string& input, const std::string& output, std::wstring& error);
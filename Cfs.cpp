@@ -0,0 +1,86 @@
+#include "stdafx.h"
+#include "Cfs.h"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <map>
+
+using namespace std;
+
+namespace {
+
+// Linux的sched_prio_to_weight，下标为nice+20
+const int kNiceToWeight[40] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+    9548, 7620, 6100, 4904, 3906,
+    3121, 2501, 1991, 1586, 1277,
+    1024, 820, 655, 526, 423,
+    335, 272, 215, 172, 137,
+    110, 87, 70, 56, 45,
+    36, 29, 23, 18, 15,
+};
+
+// 完成进程不超过该数目时逐个列出
+const size_t kFairnessListLimit = 32;
+
+// 实际与应得之比；应得为0（没有可运行时间）时视为1
+double ShareRatio(double actual, double entitled) {
+    return entitled > 0 ? actual / entitled : 1.0;
+}
+
+} // namespace
+
+int CfsNice(int priority) {
+    return min(19, max(-20, 1 - priority));
+}
+
+int CfsWeight(int priority) {
+    return kNiceToWeight[CfsNice(priority) + 20];
+}
+
+long long CfsVruntimeStep(int priority) {
+    return ((long long)kCfsNice0Weight << kCfsShift) / CfsWeight(priority);
+}
+
+void PrintFairness(const vector<ProcessPCB>& processes, const vector<PcbHandle>& finished) {
+    if (finished.empty()) return;
+
+    // 各nice值的实际与应得CPU时间之和
+    map<int, pair<double, double>> by_nice;
+    map<int, size_t> count;
+    double lowest = 0, highest = 0, sum = 0, sum_sq = 0;
+    for (size_t i = 0; i < finished.size(); i++) {
+        const ProcessPCB& pro = processes[finished[i]];
+        pair<double, double>& total = by_nice[CfsNice(pro.priority)];
+        total.first += pro.service_time;
+        total.second += pro.fair_share;
+        count[CfsNice(pro.priority)]++;
+        double ratio = ShareRatio(pro.service_time, pro.fair_share);
+        lowest = i == 0 ? ratio : min(lowest, ratio);
+        highest = i == 0 ? ratio : max(highest, ratio);
+        sum += ratio;
+        sum_sq += ratio * ratio;
+    }
+
+    wcout << L"\n公平性（实际CPU时间 / 按nice权重应得的CPU时间）：\n";
+    wcout << L"比值范围：" << lowest << L" ~ " << highest
+        << L"，Jain公平指数：" << sum * sum / (finished.size() * sum_sq) << L"\n";
+    for (const auto& entry : by_nice) {
+        wcout << L"nice " << entry.first << L"（权重" << kNiceToWeight[entry.first + 20] << L"，"
+            << count[entry.first] << L"个进程）：实际" << entry.second.first << L"，应得" << entry.second.second
+            << L"，比值" << ShareRatio(entry.second.first, entry.second.second) << L"\n";
+    }
+    if (finished.size() > kFairnessListLimit) return;
+
+    wcout << L"进程ID|进程名|nice|实际|应得|比值\n";
+    for (PcbHandle h : finished) {
+        const ProcessPCB& pro = processes[h];
+        wcout << setw(4) << pro.ID
+            << setw(10) << (pro.name.empty() ? L"P" + to_wstring(pro.ID) : pro.name)
+            << setw(6) << CfsNice(pro.priority)
+            << setw(10) << pro.service_time
+            << setw(10) << pro.fair_share
+            << setw(10) << ShareRatio(pro.service_time, pro.fair_share) << L"\n";
+    }
+}
@@ -0,0 +1,20 @@
+// Cfs.h
+#pragma once
+
+#include <vector>
+#include "ProcessSchedulingSimulator.h"
+
+// CFS（完全公平调度）的权重换算：nice值由进程优先级得出（优先级1为nice 0，每高一级nice减1，范围-20到19），
+// 权重取Linux的sched_prio_to_weight表，nice值每差1，CPU份额约差10%
+const int kCfsNice0Weight = 1024;
+const int kCfsShift = 16;  // 虚拟运行时间的定点小数位数：nice 0的进程每运行一个时间单位增加1<<16
+
+int CfsNice(int priority);
+int CfsWeight(int priority);
+
+// 每运行一个时间单位增加的虚拟运行时间（与权重成反比）
+long long CfsVruntimeStep(int priority);
+
+// 公平性报告：完成进程实际得到的CPU时间与按权重应得的CPU时间之比，
+// 按nice值汇总，进程不多时逐个列出
+void PrintFairness(const std::vector<ProcessPCB>& processes, const std::vector<PcbHandle>& finished);
@@ -0,0 +1,235 @@
+#include "stdafx.h"
+#include "EventLog.h"
+#include "ProcessSchedulingSimulator.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+namespace {
+
+wstring Widen(const string& s) { return wstring(s.begin(), s.end()); }
+
+const wchar_t* const kEventNames[] = {
+    L"arrive", L"wake", L"dispatch", L"block", L"finish", L"quantum_expired", L"preempted", L"migrate"
+};
+
+// JSONL中两个参数的字段名，空表示该事件不带此参数
+const wchar_t* const kArgNames[][2] = {
+    { nullptr, nullptr },
+    { nullptr, nullptr },
+    { L"priority", L"remaining" },
+    { L"io_time", nullptr },
+    { nullptr, nullptr },
+    { nullptr, nullptr },
+    { nullptr, nullptr },
+    { L"from_cpu", nullptr },
+};
+
+// 原调度日志中的描述，调度和进入IO的措辞随算法不同
+wstring Describe(const EventLogHeader& header, const EventRecord& rec) {
+    switch (rec.type) {
+    case EventArrive:
+        return L"到达，进入就绪队列";
+    case EventWake:
+        return L"IO完成，回到就绪队列";
+    case EventDispatch:
+        switch (header.policy) {
+        case PolicySJF:
+            return L"开始执行，服务时间" + to_wstring(rec.arg0) + L"，剩余时间" + to_wstring(rec.arg1);
+        case PolicyHRRN:
+            return L"开始执行";
+        case PolicySRTF:
+            return L"开始/被抢占执行";
+        case PolicyMLFQ:
+            return L"开始执行，级别" + to_wstring(rec.arg0) + L"，剩余时间" + to_wstring(rec.arg1);
+        case PolicyCFS:
+            return L"开始执行，时间片" + to_wstring(rec.arg0) + L"，剩余时间" + to_wstring(rec.arg1);
+        default:
+            return L"开始执行，优先级" + to_wstring(rec.arg0) + L"，剩余时间" + to_wstring(rec.arg1);
+        }
+    case EventBlock:
+        if (header.policy == PolicyHRRN || header.policy == PolicySRTF) return L"进入IO";
+        return L"进入IO，阻塞" + to_wstring(rec.arg0) + L"个时间片";
+    case EventFinish:
+        return L"完成";
+    case EventQuantumExpired:
+        return L"时间片用尽，回到就绪队列";
+    case EventPreempted:
+        return L"被抢占，回到就绪队列";
+    case EventMigrate:
+        return L"从CPU" + to_wstring(rec.arg0) + L"迁移";
+    }
+    return L"未知事件" + to_wstring(rec.type);
+}
+
+bool Selected(const EventRecord& rec, EventLevel level) {
+    return rec.type < EventTypeCount && EventLevelOf((EventType)rec.type) <= level;
+}
+
+} // namespace
+
+EventLevel EventLevelOf(EventType type) {
+    switch (type) {
+    case EventFinish:
+        return EventLevelSummary;
+    case EventArrive:
+    case EventWake:
+        return EventLevelTrace;
+    default:
+        return EventLevelSchedule;
+    }
+}
+
+EventLog::EventLog(EventLevel level, size_t capacity)
+    : m_level(level), m_head(0), m_tail(0), m_stop(false), m_file(nullptr) {
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    m_ring.resize(size);
+    m_header = EventLogHeader();
+}
+
+EventLog::~EventLog() {
+    Stop();
+}
+
+// 写入文件头（记录到文件时）并启动后台线程
+bool EventLog::Launch(int policy, int cpus) {
+    m_header.magic = kEventLogMagic;
+    m_header.version = kEventLogVersion;
+    m_header.record_size = sizeof(EventRecord);
+    m_header.policy = policy;
+    m_header.cpus = cpus;
+    m_records.clear();
+    m_head.store(0);
+    m_tail.store(0);
+    m_stop.store(false);
+    if (m_file && fwrite(&m_header, sizeof(m_header), 1, m_file) != 1) return false;
+    m_worker = thread(&EventLog::Drain, this);
+    return true;
+}
+
+void EventLog::Start(int policy, int cpus) {
+    Stop();
+    Launch(policy, cpus);
+}
+
+bool EventLog::Start(int policy, int cpus, const string& path, wstring& error) {
+    Stop();
+    m_file = fopen(path.c_str(), "wb");
+    if (!m_file) {
+        error = L"无法创建文件：" + Widen(path);
+        return false;
+    }
+    if (!Launch(policy, cpus)) {
+        Stop();
+        error = L"写入文件失败：" + Widen(path);
+        return false;
+    }
+    return true;
+}
+
+void EventLog::Stop() {
+    if (m_worker.joinable()) {
+        m_stop.store(true, memory_order_release);
+        m_worker.join();
+    }
+    if (m_file) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+// 缓冲区满：让出CPU直到后台线程取走记录
+void EventLog::WaitForSpace(size_t head) {
+    while (head - m_tail.load(memory_order_acquire) == m_ring.size()) this_thread::yield();
+}
+
+// 后台线程：成批取出环形缓冲区中的记录；缓冲区为空时短暂休眠，收到停止请求且已取完时退出
+void EventLog::Drain() {
+    const size_t mask = m_ring.size() - 1;
+    size_t tail = m_tail.load(memory_order_relaxed);
+    bool unflushed = false;
+    while (true) {
+        bool stopping = m_stop.load(memory_order_acquire);
+        size_t head = m_head.load(memory_order_acquire);
+        if (tail == head) {
+            if (stopping) break;
+            // 暂时没有新事件时把已写的刷出，读取管道或正在增长的文件的程序能及时看到（在线模式）
+            if (unflushed) fflush(m_file);
+            unflushed = false;
+            this_thread::sleep_for(chrono::microseconds(200));
+            continue;
+        }
+        while (tail != head) {
+            size_t begin = tail & mask;
+            size_t n = min(head - tail, m_ring.size() - begin);
+            if (m_file) {
+                fwrite(&m_ring[begin], sizeof(EventRecord), n, m_file);
+                unflushed = true;
+            } else {
+                m_records.insert(m_records.end(), m_ring.begin() + begin, m_ring.begin() + begin + n);
+            }
+            tail += n;
+        }
+        m_tail.store(tail, memory_order_release);
+    }
+}
+
+bool EventLogReader::Open(const string& path) {
+    m_header = nullptr;
+    m_records = nullptr;
+    m_count = 0;
+    m_error.clear();
+    if (!m_file.Open(path)) {
+        m_error = L"无法打开文件：" + Widen(path);
+        return false;
+    }
+    const EventLogHeader* header = (const EventLogHeader*)m_file.Data();
+    if (m_file.Size() < sizeof(EventLogHeader) || header->magic != kEventLogMagic) {
+        m_error = L"不是事件日志文件";
+    } else if (header->version != kEventLogVersion) {
+        m_error = L"不支持的文件版本" + to_wstring(header->version);
+    } else if (header->record_size != sizeof(EventRecord)) {
+        m_error = L"记录长度与当前版本不一致";
+    }
+    if (!m_error.empty()) {
+        m_file.Close();
+        return false;
+    }
+    m_header = header;
+    m_records = (const EventRecord*)(m_file.Data() + sizeof(EventLogHeader));
+    m_count = (m_file.Size() - sizeof(EventLogHeader)) / sizeof(EventRecord);
+    return true;
+}
+
+void ExportEventsText(const EventLogHeader& header, const EventRecord* records, size_t count,
+    EventLevel level, const ProcessNamer& namer, wostream& out) {
+    for (size_t i = 0; i < count; i++) {
+        const EventRecord& rec = records[i];
+        if (!Selected(rec, level)) continue;
+        out << L"[时间" << rec.time << L"] ";
+        if (rec.cpu >= 0 && header.cpus > 1) out << L"[CPU" << rec.cpu << L"] ";
+        out << L"进程" << (namer ? namer(rec.pid) : L"P" + to_wstring(rec.pid))
+            << L"（P" << rec.pid << L"）" << Describe(header, rec) << L"\n";
+    }
+}
+
+void ExportEventsJsonl(const EventLogHeader& header, const EventRecord* records, size_t count,
+    EventLevel level, wostream& out) {
+    for (size_t i = 0; i < count; i++) {
+        const EventRecord& rec = records[i];
+        if (!Selected(rec, level)) continue;
+        out << L"{\"time\":" << rec.time;
+        if (rec.cpu >= 0) out << L",\"cpu\":" << rec.cpu;
+        out << L",\"pid\":" << rec.pid << L",\"event\":\"" << kEventNames[rec.type] << L"\"";
+        const wchar_t* arg0 = kArgNames[rec.type][0];
+        if (rec.type == EventDispatch && header.policy == PolicySJF) arg0 = L"service_time";
+        if (rec.type == EventDispatch && header.policy == PolicyHRRN) arg0 = L"ratio_x10000";
+        if (rec.type == EventDispatch && header.policy == PolicyMLFQ) arg0 = L"level";
+        if (rec.type == EventDispatch && header.policy == PolicyCFS) arg0 = L"slice";
+        if (arg0) out << L",\"" << arg0 << L"\":" << rec.arg0;
+        if (kArgNames[rec.type][1]) out << L",\"" << kArgNames[rec.type][1] << L"\":" << rec.arg1;
+        out << L"}\n";
+    }
+}
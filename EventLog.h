@@ -0,0 +1,139 @@
+// EventLog.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MappedFile.h"
+
+// 调度事件类型
+enum EventType {
+    EventArrive,          // 到达，进入就绪队列
+    EventWake,            // IO完成，回到就绪队列
+    EventDispatch,        // 开始执行；arg0为优先级（SJF为服务时间），arg1为剩余时间
+    EventBlock,           // 进入IO；arg0为阻塞时长
+    EventFinish,          // 完成
+    EventQuantumExpired,  // 时间片用尽，回到就绪队列
+    EventPreempted,       // 被抢占，回到就绪队列
+    EventMigrate,         // 从其他CPU的就绪队列迁移过来；arg0为原CPU
+    EventTypeCount
+};
+
+// 详细程度：记录和导出时只保留不高于该级别的事件
+enum EventLevel {
+    EventLevelOff = 0,
+    EventLevelSummary = 1,   // 只有完成事件
+    EventLevelSchedule = 2,  // 调度、IO、回队和迁移（与原先的调度日志相同）
+    EventLevelTrace = 3      // 另外包括到达和IO完成
+};
+
+// 定长的二进制事件记录
+struct EventRecord {
+    int64_t time;
+    int32_t pid;
+    int16_t cpu;
+    uint8_t type;
+    uint8_t reserved;
+    int32_t arg0, arg1;
+};
+
+// 事件日志文件头，之后直到文件末尾都是EventRecord
+const uint32_t kEventLogMagic = 0x56455350;  // "PSEV"
+const uint16_t kEventLogVersion = 1;
+
+struct EventLogHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    int32_t policy;
+    int32_t cpus;
+};
+
+EventLevel EventLevelOf(EventType type);
+
+// 事件日志：模拟线程把记录写入无锁的单生产者单消费者环形缓冲区，由后台线程取出，
+// 追加到内存或写入文件。模拟过程中不做任何格式化；缓冲区满时模拟线程等待后台线程腾出空间。
+// 不记录事件时调度器不持有日志，热路径上只有一次空指针判断。
+class EventLog {
+public:
+    explicit EventLog(EventLevel level, size_t capacity = 1 << 16);
+    ~EventLog();
+
+    // 开始记录到内存（Stop后用Records取出）
+    void Start(int policy, int cpus);
+    // 开始记录到文件
+    bool Start(int policy, int cpus, const std::string& path, std::wstring& error);
+    // 等待后台线程写完全部记录
+    void Stop();
+
+    bool Wants(EventType type) const { return EventLevelOf(type) <= m_level; }
+
+    void Record(EventType type, int64_t time, int pid, int cpu, int arg0 = 0, int arg1 = 0) {
+        if (!Wants(type)) return;
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == m_ring.size()) WaitForSpace(head);
+        EventRecord& rec = m_ring[head & (m_ring.size() - 1)];
+        rec.time = time;
+        rec.pid = pid;
+        rec.cpu = (int16_t)cpu;
+        rec.type = (uint8_t)type;
+        rec.reserved = 0;
+        rec.arg0 = arg0;
+        rec.arg1 = arg1;
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    const std::vector<EventRecord>& Records() const { return m_records; }
+    const EventLogHeader& Header() const { return m_header; }
+
+private:
+    EventLog(const EventLog&);
+    EventLog& operator=(const EventLog&);
+
+    bool Launch(int policy, int cpus);
+    void WaitForSpace(size_t head);
+    void Drain();
+
+    EventLevel m_level;
+    EventLogHeader m_header;
+    std::vector<EventRecord> m_ring;   // 容量为2的幂
+    std::atomic<size_t> m_head;        // 只由模拟线程写
+    std::atomic<size_t> m_tail;        // 只由后台线程写
+    std::atomic<bool> m_stop;
+    std::thread m_worker;
+    FILE* m_file;
+    std::vector<EventRecord> m_records;
+};
+
+// 读取事件日志文件（内存映射）
+class EventLogReader {
+public:
+    bool Open(const std::string& path);
+    const std::wstring& Error() const { return m_error; }
+    const EventLogHeader& Header() const { return *m_header; }
+    const EventRecord* Records() const { return m_records; }
+    size_t Count() const { return m_count; }
+
+private:
+    MappedFile m_file;
+    const EventLogHeader* m_header;
+    const EventRecord* m_records;
+    size_t m_count;
+    std::wstring m_error;
+};
+
+// 进程ID到显示名的映射，导出文本时使用
+typedef std::function<std::wstring(int)> ProcessNamer;
+
+// 按原调度日志的格式输出，例如"[时间3] 进程A（P1）开始执行，优先级2，剩余时间4"
+void ExportEventsText(const EventLogHeader& header, const EventRecord* records, size_t count,
+    EventLevel level, const ProcessNamer& namer, std::wostream& out);
+
+// 每行一个JSON对象
+void ExportEventsJsonl(const EventLogHeader& header, const EventRecord* records, size_t count,
+    EventLevel level, std::wostream& out);
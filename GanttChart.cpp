@@ -8,35 +8,24 @@
 
 using namespace std;
 
-// HSV转RGB辅助函数
-static COLORREF HSVtoRGB(double h, double s, double v) {
-    double r = 0, g = 0, b = 0;
-    int i = int(h * 6);
-    double f = h * 6 - i;
-    double p = v * (1 - s);
-    double q = v * (1 - f * s);
-    double t = v * (1 - (1 - f) * s);
-    switch (i % 6) {
-    case 0: r = v, g = t, b = p; break;
-    case 1: r = q, g = v, b = p; break;
-    case 2: r = p, g = v, b = t; break;
-    case 3: r = p, g = q, b = v; break;
-    case 4: r = t, g = p, b = v; break;
-    case 5: r = v, g = p, b = q; break;
-    }
-    return RGB(int(r * 255), int(g * 255), int(b * 255));
+// 场景颜色0xRRGGBB转为COLORREF
+static COLORREF ToColorRef(uint32_t color) {
+    return RGB((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF);
 }
 
 // 构造函数
 GanttChart::GanttChart() {}
 
 // 显示甘特图窗口
-void GanttChart::Show(const vector<pair<int, int>>& gantt_data,
+void GanttChart::Show(const vector<Timeline>& lanes,
     const vector<ProcessPCB>& processes) {
-    if (gantt_data.empty()) return;
+    bool empty = true;
+    for (const Timeline& lane : lanes) empty = empty && lane.empty();
+    if (empty) return;
 
-    m_gantt_data = gantt_data;
+    m_lanes = lanes;
     m_processes = processes;
+    m_renderer.reset(new GanttRenderer(m_lanes, m_processes));
 
     // 注册窗口类（只注册一次）
     static bool registered = false;
@@ -109,122 +98,37 @@ LRESULT CALLBACK GanttChart::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
     return DefWindowProcW(hwnd, uMsg, wParam, lParam);
 }
 
-// 绘制主函数
+// 绘制主函数：布局只与段数和窗口宽度成正比，窄段已合并为密度带
 void GanttChart::OnPaint(HDC hdc) {
-    if (m_gantt_data.empty()) return;
+    if (!m_renderer) return;
 
     RECT clientRect;
     GetClientRect(WindowFromDC(hdc), &clientRect);
-    int width = clientRect.right - clientRect.left;
-    int height = clientRect.bottom - clientRect.top;
-
-    HBRUSH hBrush = CreateSolidBrush(RGB(255, 255, 255));
-    FillRect(hdc, &clientRect, hBrush);
-    DeleteObject(hBrush);
-
-    int max_time = 1;
-    if (!m_gantt_data.empty()) {
-        max_time = m_gantt_data.back().second;
-        if (max_time == 0) max_time = 1;
+    FillRect(hdc, &clientRect, (HBRUSH)GetStockObject(WHITE_BRUSH));
+
+    GanttOptions options;
+    options.width = clientRect.right - clientRect.left;
+    options.height = clientRect.bottom - clientRect.top;
+    GanttScene scene = m_renderer->Layout(options);
+
+    // 所有矩形共用DC画刷，只切换颜色，不为每段创建画刷
+    HGDIOBJ oldBrush = SelectObject(hdc, GetStockObject(DC_BRUSH));
+    for (const GanttRect& r : scene.rects) {
+        SetDCBrushColor(hdc, ToColorRef(r.color));
+        if (r.outline)
+            Rectangle(hdc, r.x1, r.y1, r.x2, r.y2);
+        else
+            PatBlt(hdc, r.x1, r.y1, r.x2 - r.x1, r.y2 - r.y1, PATCOPY);
     }
+    SelectObject(hdc, oldBrush);
 
-    DrawTimeAxis(hdc, width, height, max_time);
-    DrawProcesses(hdc, width, height, m_gantt_data, max_time);
-    DrawLegend(hdc, width, height, m_processes);
-}
-
-// 获取进程颜色
-COLORREF GanttChart::GetProcessColor(int process_id) {
-    double h = (process_id * 0.618033988749895);
-    h = h - floor(h);
-    return HSVtoRGB(h, 0.5, 0.95);
-}
-
-// 绘制时间轴
-void GanttChart::DrawTimeAxis(HDC hdc, int width, int height, int max_time) {
-    int margin = 50;
-    int chartWidth = width - 2 * margin;
-
-    MoveToEx(hdc, margin, height - margin, NULL);
-    LineTo(hdc, width - margin, height - margin);
-    MoveToEx(hdc, margin, height - margin, NULL);
-    LineTo(hdc, margin, margin);
-
-    int step = (max_time / 10) > 0 ? (max_time / 10) : 1;
-    for (int t = 0; t <= max_time; t += step) {
-        int x = margin + (t * chartWidth) / max_time;
-        MoveToEx(hdc, x, height - margin, NULL);
-        LineTo(hdc, x, height - margin + 5);
-
-        std::wstring label = std::to_wstring(t);
-        TextOutW(hdc, x - 10, height - margin + 10, label.c_str(), (int)label.length());
+    for (const GanttLine& l : scene.lines) {
+        MoveToEx(hdc, l.x1, l.y1, NULL);
+        LineTo(hdc, l.x2, l.y2);
     }
 
-    std::wstring title = L"Gantt Chart";
-    TextOutW(hdc, width / 2 - 50, margin / 2, title.c_str(), (int)title.length());
-}
-
-// 绘制进程条
-void GanttChart::DrawProcesses(HDC hdc, int width, int height,
-    const std::vector<std::pair<int, int>>& gantt_data,
-    int max_time) {
-    int margin = 50;
-    int chartWidth = width - 2 * margin;
-    int barHeight = 30;
-    int y = height - margin - barHeight - 30;
-
-    int prev_time = 0;
-    int prev_process = -1;
-
-    for (size_t i = 0; i < gantt_data.size(); ++i) {
-        int process_id = gantt_data[i].first;
-        int time = gantt_data[i].second;
-
-        if (prev_process != -1 && prev_time < time) {
-            int x1 = margin + (prev_time * chartWidth) / max_time;
-            int x2 = margin + (time * chartWidth) / max_time;
-
-            HBRUSH brush = CreateSolidBrush(GetProcessColor(prev_process));
-            HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, brush);
-            Rectangle(hdc, x1, y, x2, y + barHeight);
-            SelectObject(hdc, oldBrush);
-            DeleteObject(brush);
-
-            std::wstring label = L"P" + std::to_wstring(prev_process);
-            SIZE textSize;
-            GetTextExtentPoint32W(hdc, label.c_str(), (int)label.length(), &textSize);
-            int label_x = x1 + (x2 - x1 - textSize.cx) / 2;
-            int label_y = y + (barHeight - textSize.cy) / 2;
-            if (label_x < x1 + 2) label_x = x1 + 2;
-            TextOutW(hdc, label_x, label_y, label.c_str(), (int)label.length());
-        }
-
-        prev_time = time;
-        prev_process = process_id;
+    SetBkMode(hdc, TRANSPARENT);
+    for (const GanttText& t : scene.texts) {
+        TextOutW(hdc, t.x, t.y, t.text.c_str(), (int)t.text.length());
     }
 }
-
-// 绘制图例
-void GanttChart::DrawLegend(HDC hdc, int width, int height,
-    const std::vector<ProcessPCB>& processes) {
-    int margin = 50;
-    int x = width - 150;
-    int y = margin + 20;
-    int boxSize = 15;
-    int spacing = 25;
-
-    TextOutW(hdc, x, y - 20, L"Legend", 6);
-
-    for (size_t i = 0; i < processes.size(); ++i) {
-        HBRUSH brush = CreateSolidBrush(GetProcessColor(processes[i].ID));
-        HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, brush);
-        Rectangle(hdc, x, y, x + boxSize, y + boxSize);
-        SelectObject(hdc, oldBrush);
-        DeleteObject(brush);
-
-        std::wstring label = L"P" + std::to_wstring(processes[i].ID);
-        TextOutW(hdc, x + boxSize + 5, y, label.c_str(), (int)label.length());
-
-        y += spacing;
-    }
-}
\ No newline at end of file
@@ -6,15 +6,17 @@
 #include <vector>
 #include <Windows.h>
 #include <string>
+#include <memory>
 #include "ProcessSchedulingSimulator.h"
+#include "GanttRender.h"
 
 // 不建议 using namespace std; 放在头文件，建议去掉
 
 // 甘特图绘制类
 class GanttChart {
 public:
-    // 显示甘特图窗口
-    void Show(const std::vector<std::pair<int, int>>& gantt_data,
+    // 显示甘特图窗口，lanes[i]为第i个CPU的时间线，每个CPU画一行
+    void Show(const std::vector<Timeline>& lanes,
               const std::vector<ProcessPCB>& processes);
 
     // 构造函数
@@ -25,24 +27,10 @@ private:
     static LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg,
         WPARAM wParam, LPARAM lParam);
 
-    // 绘制图形内容
+    // 按当前窗口大小布局后绘制
     void OnPaint(HDC hdc);
 
-    // 绘制时间轴
-    void DrawTimeAxis(HDC hdc, int width, int height, int max_time);
-
-    // 绘制进程调度条
-    void DrawProcesses(HDC hdc, int width, int height,
-        const std::vector<std::pair<int, int>>& gantt_data,
-        int max_time);
-
-    // 绘制图例说明
-    void DrawLegend(HDC hdc, int width, int height,
-        const std::vector<ProcessPCB>& processes);
-
-    // 获取进程对应的显示颜色
-    COLORREF GetProcessColor(int process_id);
-
-    std::vector<std::pair<int, int>> m_gantt_data;  // 存储甘特图数据
+    std::vector<Timeline> m_lanes;                  // 存储甘特图数据（每个CPU一条）
     std::vector<ProcessPCB> m_processes;            // 存储进程信息
+    std::unique_ptr<GanttRenderer> m_renderer;      // 布局和颜色缓存，引用上面两项
 };
@@ -0,0 +1,597 @@
+#include "stdafx.h"
+#include "GanttRender.h"
+#include "Utf8.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+const int kMarginLeft = 70, kMarginTop = 40, kMarginBottom = 40;
+const int kLegendWidth = 120;
+const int kDensityLevels = 8;     // 密度带的灰度档位数
+const size_t kPaletteLimit = 1 << 20;
+
+wstring Widen(const string& s) { return wstring(s.begin(), s.end()); }
+
+// HSV转RGB
+uint32_t HsvToRgb(double h, double s, double v) {
+    double r = 0, g = 0, b = 0;
+    int i = int(h * 6);
+    double f = h * 6 - i;
+    double p = v * (1 - s);
+    double q = v * (1 - f * s);
+    double t = v * (1 - (1 - f) * s);
+    switch (i % 6) {
+    case 0: r = v, g = t, b = p; break;
+    case 1: r = q, g = v, b = p; break;
+    case 2: r = p, g = v, b = t; break;
+    case 3: r = p, g = q, b = v; break;
+    case 4: r = t, g = p, b = v; break;
+    case 5: r = v, g = p, b = q; break;
+    }
+    return ((uint32_t)int(r * 255) << 16) | ((uint32_t)int(g * 255) << 8) | (uint32_t)int(b * 255);
+}
+
+// 占用率档位对应的灰度：档位越高越深
+uint32_t DensityColor(int level) {
+    uint32_t c = 255 - (255 - 0x40) * level / kDensityLevels;
+    return (c << 16) | (c << 8) | c;
+}
+
+// 刻度间隔取1、2、5乘10的幂，约10个刻度
+long long TickStep(long long max_time) {
+    long long step = 1;
+    while (true) {
+        if (step * 10 >= max_time) return step;
+        if (step * 20 >= max_time) return step * 2;
+        if (step * 50 >= max_time) return step * 5;
+        step *= 10;
+    }
+}
+
+int TextWidth(const wstring& text) {
+    return (int)text.size() * kGanttCharWidth;
+}
+
+// 5x7点阵字体：每个字符7行，每行低5位从左到右
+struct Glyph {
+    char ch;
+    unsigned char rows[7];
+};
+
+const Glyph kFont[] = {
+    { '0', { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E } },
+    { '1', { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+    { '2', { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F } },
+    { '3', { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E } },
+    { '4', { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 } },
+    { '5', { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E } },
+    { '6', { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E } },
+    { '7', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 } },
+    { '8', { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E } },
+    { '9', { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C } },
+    { 'A', { 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 } },
+    { 'B', { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E } },
+    { 'C', { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E } },
+    { 'D', { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C } },
+    { 'E', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F } },
+    { 'F', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 } },
+    { 'G', { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F } },
+    { 'H', { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+    { 'I', { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+    { 'J', { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C } },
+    { 'K', { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 } },
+    { 'L', { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F } },
+    { 'M', { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 } },
+    { 'N', { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 } },
+    { 'O', { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+    { 'P', { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 } },
+    { 'Q', { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D } },
+    { 'R', { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 } },
+    { 'S', { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E } },
+    { 'T', { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+    { 'U', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+    { 'V', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 } },
+    { 'W', { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A } },
+    { 'X', { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 } },
+    { 'Y', { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 } },
+    { 'Z', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F } },
+    { '-', { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 } },
+    { '.', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C } },
+    { ':', { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 } },
+    { '(', { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 } },
+    { ')', { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 } },
+};
+
+const Glyph* FindGlyph(wchar_t ch) {
+    if (ch >= L'a' && ch <= L'z') ch = ch - L'a' + L'A';
+    for (const Glyph& glyph : kFont) {
+        if ((wchar_t)glyph.ch == ch) return &glyph;
+    }
+    return nullptr;
+}
+
+// RGB帧缓冲区
+class Raster {
+public:
+    Raster(int width, int height) : m_width(width), m_height(height), m_pixels((size_t)width * height * 3, 255) {}
+
+    void Fill(int x1, int y1, int x2, int y2, uint32_t color) {
+        x1 = max(x1, 0), y1 = max(y1, 0), x2 = min(x2, m_width), y2 = min(y2, m_height);
+        for (int y = y1; y < y2; y++) {
+            unsigned char* p = &m_pixels[((size_t)y * m_width + x1) * 3];
+            for (int x = x1; x < x2; x++, p += 3) {
+                p[0] = (unsigned char)(color >> 16);
+                p[1] = (unsigned char)(color >> 8);
+                p[2] = (unsigned char)color;
+            }
+        }
+    }
+
+    void Outline(int x1, int y1, int x2, int y2) {
+        Fill(x1, y1, x2, y1 + 1, 0);
+        Fill(x1, y2 - 1, x2, y2, 0);
+        Fill(x1, y1, x1 + 1, y2, 0);
+        Fill(x2 - 1, y1, x2, y2, 0);
+    }
+
+    // 只有水平线和竖线
+    void Line(int x1, int y1, int x2, int y2) {
+        Fill(min(x1, x2), min(y1, y2), max(x1, x2) + 1, max(y1, y2) + 1, 0);
+    }
+
+    // 字形在12像素高的文字框内垂直居中
+    void Text(int x, int y, const wstring& text) {
+        for (wchar_t ch : text) {
+            if (const Glyph* glyph = FindGlyph(ch)) {
+                for (int row = 0; row < 7; row++) {
+                    for (int col = 0; col < 5; col++) {
+                        if (glyph->rows[row] & (0x10 >> col)) Fill(x + col, y + 2 + row, x + col + 1, y + 3 + row, 0);
+                    }
+                }
+            }
+            x += kGanttCharWidth;
+        }
+    }
+
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+    const unsigned char* Row(int y) const { return &m_pixels[(size_t)y * m_width * 3]; }
+
+private:
+    int m_width, m_height;
+    vector<unsigned char> m_pixels;
+};
+
+struct CrcTable {
+    uint32_t entries[256];
+
+    CrcTable() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            entries[i] = c;
+        }
+    }
+};
+
+uint32_t Crc32(const unsigned char* data, size_t size) {
+    static const CrcTable table;
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+void PutBigEndian(string& out, uint32_t value) {
+    out.push_back((char)(value >> 24));
+    out.push_back((char)(value >> 16));
+    out.push_back((char)(value >> 8));
+    out.push_back((char)value);
+}
+
+void PutChunk(string& out, const char* type, const string& data) {
+    PutBigEndian(out, (uint32_t)data.size());
+    string body = type + data;
+    out += body;
+    PutBigEndian(out, Crc32((const unsigned char*)body.data(), body.size()));
+}
+
+// 按位输出，先写低位（deflate的位序）
+class BitWriter {
+public:
+    explicit BitWriter(string& out) : m_out(out), m_bits(0), m_count(0) {}
+
+    void Put(uint32_t value, int bits) {
+        m_bits |= (uint64_t)value << m_count;
+        m_count += bits;
+        while (m_count >= 8) {
+            m_out.push_back((char)(m_bits & 0xFF));
+            m_bits >>= 8;
+            m_count -= 8;
+        }
+    }
+
+    // Huffman码从高位开始写
+    void PutCode(uint32_t code, int bits) {
+        uint32_t reversed = 0;
+        for (int i = 0; i < bits; i++) reversed |= ((code >> i) & 1) << (bits - 1 - i);
+        Put(reversed, bits);
+    }
+
+    void Flush() {
+        if (m_count > 0) m_out.push_back((char)(m_bits & 0xFF));
+        m_bits = 0;
+        m_count = 0;
+    }
+
+private:
+    string& m_out;
+    uint64_t m_bits;
+    int m_count;
+};
+
+const int kLengthBase[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59,
+    67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const int kLengthExtra[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const int kDistanceBase[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+    1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+const int kDistanceExtra[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+// 固定Huffman表中的字面量/长度符号
+void PutSymbol(BitWriter& out, int symbol) {
+    if (symbol < 144) out.PutCode(0x30 + symbol, 8);
+    else if (symbol < 256) out.PutCode(0x190 + symbol - 144, 9);
+    else if (symbol < 280) out.PutCode(symbol - 256, 7);
+    else out.PutCode(0xC0 + symbol - 280, 8);
+}
+
+void PutMatch(BitWriter& out, int length, int distance) {
+    int code = 28;
+    while (kLengthBase[code] > length) code--;
+    PutSymbol(out, 257 + code);
+    out.Put(length - kLengthBase[code], kLengthExtra[code]);
+    code = 29;
+    while (kDistanceBase[code] > distance) code--;
+    out.PutCode(code, 5);
+    out.Put(distance - kDistanceBase[code], kDistanceExtra[code]);
+}
+
+// zlib流：固定Huffman编码的单个deflate块，只找与前一个像素或上一行相同的重复，
+// 甘特图由大片纯色组成，这已足够把图像压缩到原来的几十分之一
+string Deflate(const string& data, size_t row_length) {
+    string out = "\x78\x01";
+    BitWriter bits(out);
+    bits.Put(1, 1);  // 最后一块
+    bits.Put(1, 2);  // 固定Huffman
+    const size_t distances[] = { 3, row_length };
+    size_t pos = 0;
+    while (pos < data.size()) {
+        size_t best_length = 0, best_distance = 0;
+        for (size_t distance : distances) {
+            if (distance > pos || distance > 32768) continue;
+            size_t limit = min<size_t>(258, data.size() - pos), length = 0;
+            while (length < limit && data[pos + length] == data[pos + length - distance]) length++;
+            if (length > best_length) best_length = length, best_distance = distance;
+        }
+        if (best_length >= 3) {
+            PutMatch(bits, (int)best_length, (int)best_distance);
+            pos += best_length;
+        } else {
+            PutSymbol(bits, (unsigned char)data[pos]);
+            pos++;
+        }
+    }
+    PutSymbol(bits, 256);
+    bits.Flush();
+
+    uint32_t a = 1, b = 0;
+    for (unsigned char c : data) {
+        a = (a + c) % 65521;
+        b = (b + a) % 65521;
+    }
+    PutBigEndian(out, (b << 16) | a);
+    return out;
+}
+
+void AppendEscaped(string& out, const wstring& text) {
+    string utf8;
+    EncodeUtf8(text, utf8);
+    for (char c : utf8) {
+        switch (c) {
+        case '&': out += "&amp;"; break;
+        case '<': out += "&lt;"; break;
+        case '>': out += "&gt;"; break;
+        case '"': out += "&quot;"; break;
+        default: out.push_back(c); break;
+        }
+    }
+}
+
+bool WriteFile(const string& path, const string& data, wstring& error) {
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp) {
+        error = L"无法创建文件：" + Widen(path);
+        return false;
+    }
+    bool ok = fwrite(data.data(), 1, data.size(), fp) == data.size();
+    if (fclose(fp) != 0) ok = false;
+    if (!ok) error = L"写入文件失败：" + Widen(path);
+    return ok;
+}
+
+} // namespace
+
+GanttRenderer::GanttRenderer(const vector<Timeline>& lanes, const vector<ProcessPCB>& processes)
+    : m_lanes(lanes), m_processes(processes), m_left(0), m_scale(1), m_row_start(0), m_row_y(0), m_row_h(0) {}
+
+uint32_t GanttRenderer::ProcessColor(int pid) {
+    if (pid < 0 || (size_t)pid >= kPaletteLimit) {
+        double h = pid * 0.618033988749895;
+        return HsvToRgb(h - floor(h), 0.5, 0.95);
+    }
+    if ((size_t)pid >= m_palette.size()) m_palette.resize(pid + 1, 0);
+    uint32_t& color = m_palette[pid];
+    if (color == 0) {
+        double h = pid * 0.618033988749895;
+        color = HsvToRgb(h - floor(h), 0.5, 0.95);
+    }
+    return color;
+}
+
+// 开始一行（可能由多条泳道合并而成）
+void GanttRenderer::BeginRow(GanttScene& scene, int y, int h) {
+    m_row_start = scene.rects.size();
+    m_row_y = y;
+    m_row_h = h;
+}
+
+// 把一条泳道的段加入当前行：宽段直接生成矩形，窄段计入像素列的占用
+void GanttRenderer::AddSegments(GanttScene& scene, const TimelineSegment* begin, const TimelineSegment* end) {
+    const int chart_width = (int)m_coverage.size();
+    const bool labels = m_row_h >= kGanttTextHeight + 2;
+    for (const TimelineSegment* seg = begin; seg != end; ++seg) {
+        if (seg->pid == kIdlePid) continue;
+        double fx1 = seg->start * m_scale, fx2 = seg->end * m_scale;
+        if (fx2 - fx1 >= 1) {
+            GanttRect rect;
+            rect.x1 = m_left + (int)fx1;
+            rect.x2 = max(m_left + (int)fx2, rect.x1 + 1);
+            rect.y1 = m_row_y;
+            rect.y2 = m_row_y + m_row_h;
+            rect.color = ProcessColor(seg->pid);
+            rect.outline = rect.x2 - rect.x1 >= 3 && m_row_h >= 3;
+            scene.rects.push_back(rect);
+            if (labels) {
+                // 放不下的标签不生成
+                GanttText label;
+                label.text = L"P" + to_wstring(seg->pid);
+                int width = TextWidth(label.text);
+                if (width + 4 <= rect.x2 - rect.x1) {
+                    label.x = (rect.x1 + rect.x2 - width) / 2;
+                    label.y = m_row_y + (m_row_h - kGanttTextHeight) / 2;
+                    scene.texts.push_back(label);
+                }
+            }
+            continue;
+        }
+        int col = min((int)fx1, chart_width - 1);
+        double boundary = col + 1;
+        if (fx2 <= boundary) {
+            m_coverage[col] += fx2 - fx1;
+        } else {
+            m_coverage[col] += boundary - fx1;
+            if (col + 1 < chart_width) m_coverage[col + 1] += fx2 - boundary;
+        }
+    }
+}
+
+// 结束一行：占用率按合并的泳道数取平均，相邻同档位的列合并为密度带，画在宽段之下
+void GanttRenderer::EndRow(GanttScene& scene, int lanes) {
+    vector<GanttRect> bands;
+    const int chart_width = (int)m_coverage.size();
+    int run_start = 0, run_level = 0;
+    for (int col = 0; col <= chart_width; col++) {
+        int level = 0;
+        if (col < chart_width && m_coverage[col] > 0) {
+            level = (int)ceil(m_coverage[col] / lanes * kDensityLevels);
+            level = min(max(level, 1), kDensityLevels);
+            m_coverage[col] = 0;
+        }
+        if (level == run_level) continue;
+        if (run_level > 0) {
+            GanttRect band = { m_left + run_start, m_row_y, m_left + col, m_row_y + m_row_h, DensityColor(run_level), false };
+            bands.push_back(band);
+        }
+        run_start = col;
+        run_level = level;
+    }
+    scene.rects.insert(scene.rects.begin() + m_row_start, bands.begin(), bands.end());
+}
+
+GanttScene GanttRenderer::Layout(const GanttOptions& options) {
+    GanttScene scene;
+    long long max_time = 1;
+    for (const Timeline& lane : m_lanes) max_time = max(max_time, lane.EndTime());
+
+    // 泳道：每个CPU一条，或每个进程一条（按ID排序，段从各CPU的时间线收集）
+    vector<TimelineSegment> by_process;
+    vector<size_t> lane_begin;
+    vector<int> ids;
+    if (options.per_process) {
+        for (const ProcessPCB& pro : m_processes) ids.push_back(pro.ID);
+        sort(ids.begin(), ids.end());
+        ids.erase(unique(ids.begin(), ids.end()), ids.end());
+        lane_begin.assign(ids.size() + 1, 0);
+        auto lane_of = [&ids](int pid) { return (size_t)(lower_bound(ids.begin(), ids.end(), pid) - ids.begin()); };
+        for (const Timeline& timeline : m_lanes) {
+            for (const TimelineSegment& seg : timeline.Segments()) {
+                if (seg.pid != kIdlePid && binary_search(ids.begin(), ids.end(), seg.pid)) lane_begin[lane_of(seg.pid) + 1]++;
+            }
+        }
+        for (size_t i = 1; i < lane_begin.size(); i++) lane_begin[i] += lane_begin[i - 1];
+        by_process.resize(lane_begin.back());
+        vector<size_t> fill(lane_begin.begin(), lane_begin.end() - 1);
+        for (const Timeline& timeline : m_lanes) {
+            for (const TimelineSegment& seg : timeline.Segments()) {
+                if (seg.pid != kIdlePid && binary_search(ids.begin(), ids.end(), seg.pid))
+                    by_process[fill[lane_of(seg.pid)]++] = seg;
+            }
+        }
+    }
+    const size_t lanes = options.per_process ? ids.size() : m_lanes.size();
+
+    bool legend = !options.per_process && !m_processes.empty() && m_processes.size() <= options.legend_limit;
+    int right = legend ? kLegendWidth : 20;
+    int chart_width = max(1, options.width - kMarginLeft - right);
+    int lanes_height;
+    if (options.height > 0)
+        lanes_height = max(1, options.height - kMarginTop - kMarginBottom);
+    else
+        lanes_height = (int)max<long long>(1, min<long long>(options.max_lanes_height, (long long)max<size_t>(lanes, 1) * options.lane_height));
+    scene.width = kMarginLeft + chart_width + right;
+    scene.height = kMarginTop + lanes_height + kMarginBottom;
+
+    m_left = kMarginLeft;
+    m_scale = (double)chart_width / max_time;
+    m_coverage.assign(chart_width, 0);
+
+    // 泳道多于像素行时相邻泳道合并到同一行
+    const long long rows = min<long long>((long long)lanes, lanes_height);
+    size_t lane = 0;
+    for (long long row = 0; row < rows; row++) {
+        int y1 = kMarginTop + (int)(row * lanes_height / rows);
+        int y2 = kMarginTop + (int)((row + 1) * lanes_height / rows);
+        int h = y2 - y1;
+        if (h >= 12) h -= h / 4;  // 泳道间留出间隔
+        BeginRow(scene, y1, h);
+        size_t first = lane;
+        for (; lane < lanes && (long long)lane * rows / (long long)lanes == row; lane++) {
+            if (options.per_process)
+                AddSegments(scene, by_process.data() + lane_begin[lane], by_process.data() + lane_begin[lane + 1]);
+            else
+                AddSegments(scene, m_lanes[lane].Segments().data(), m_lanes[lane].Segments().data() + m_lanes[lane].Segments().size());
+        }
+        EndRow(scene, (int)(lane - first));
+
+        // 一行只有一条泳道且高度足够时在左侧标注
+        if (lane - first == 1 && h >= 10 && (options.per_process || m_lanes.size() > 1)) {
+            GanttText name;
+            name.text = options.per_process ? L"P" + to_wstring(ids[first]) : L"CPU" + to_wstring(first);
+            name.x = max(2, kMarginLeft - 6 - TextWidth(name.text));
+            name.y = y1 + (h - kGanttTextHeight) / 2;
+            scene.texts.push_back(name);
+        }
+    }
+
+    // 时间轴
+    int axis_y = kMarginTop + lanes_height + 2;
+    scene.lines.push_back(GanttLine{ kMarginLeft, axis_y, kMarginLeft + chart_width, axis_y });
+    scene.lines.push_back(GanttLine{ kMarginLeft, kMarginTop, kMarginLeft, axis_y });
+    long long step = TickStep(max_time);
+    for (long long t = 0; t <= max_time; t += step) {
+        int x = kMarginLeft + (int)(t * m_scale);
+        scene.lines.push_back(GanttLine{ x, axis_y, x, axis_y + 5 });
+        GanttText label;
+        label.text = to_wstring(t);
+        label.x = x - TextWidth(label.text) / 2;
+        label.y = axis_y + 8;
+        scene.texts.push_back(label);
+    }
+
+    GanttText title;
+    title.text = L"Gantt Chart";
+    if (!legend && !options.per_process && !m_processes.empty())
+        title.text += L" (" + to_wstring(m_processes.size()) + L" processes)";
+    title.x = (scene.width - TextWidth(title.text)) / 2;
+    title.y = kMarginTop / 2 - kGanttTextHeight / 2;
+    scene.texts.push_back(title);
+
+    // 图例放在右侧边栏，放不下的进程省略
+    if (legend) {
+        int x = kMarginLeft + chart_width + 15, y = kMarginTop;
+        scene.texts.push_back(GanttText{ x, y, L"Legend" });
+        y += 20;
+        for (const ProcessPCB& pro : m_processes) {
+            if (y + kGanttTextHeight > scene.height - 4) {
+                scene.texts.push_back(GanttText{ x, y, L"..." });
+                break;
+            }
+            scene.rects.push_back(GanttRect{ x, y, x + 12, y + 12, ProcessColor(pro.ID), true });
+            scene.texts.push_back(GanttText{ x + 17, y, L"P" + to_wstring(pro.ID) });
+            y += 18;
+        }
+    }
+    return scene;
+}
+
+bool WriteGantt(const GanttScene& scene, const string& path, wstring& error) {
+    string ext = path.size() >= 4 ? path.substr(path.size() - 4) : "";
+    transform(ext.begin(), ext.end(), ext.begin(), [](char c) { return (char)tolower((unsigned char)c); });
+    if (ext == ".svg") return WriteGanttSvg(scene, path, error);
+    if (ext == ".png") return WriteGanttPng(scene, path, error);
+    error = L"甘特图文件的扩展名应为.svg或.png：" + Widen(path);
+    return false;
+}
+
+bool WriteGanttSvg(const GanttScene& scene, const string& path, wstring& error) {
+    string out;
+    out.reserve(128 + scene.rects.size() * 64 + scene.texts.size() * 64);
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer),
+        "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\" viewBox=\"0 0 %d %d\">\n"
+        "<rect width=\"100%%\" height=\"100%%\" fill=\"#ffffff\"/>\n",
+        scene.width, scene.height, scene.width, scene.height);
+    out += buffer;
+    for (const GanttRect& r : scene.rects) {
+        snprintf(buffer, sizeof(buffer), "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"#%06x\"%s/>\n",
+            r.x1, r.y1, r.x2 - r.x1, r.y2 - r.y1, (unsigned)r.color,
+            r.outline ? " stroke=\"#000000\" stroke-width=\"1\"" : "");
+        out += buffer;
+    }
+    out += "<g stroke=\"#000000\" stroke-width=\"1\">\n";
+    for (const GanttLine& l : scene.lines) {
+        snprintf(buffer, sizeof(buffer), "<line x1=\"%d\" y1=\"%d\" x2=\"%d\" y2=\"%d\"/>\n", l.x1, l.y1, l.x2, l.y2);
+        out += buffer;
+    }
+    out += "</g>\n<g font-family=\"monospace\" font-size=\"12\" dominant-baseline=\"text-before-edge\">\n";
+    for (const GanttText& t : scene.texts) {
+        snprintf(buffer, sizeof(buffer), "<text x=\"%d\" y=\"%d\">", t.x, t.y);
+        out += buffer;
+        AppendEscaped(out, t.text);
+        out += "</text>\n";
+    }
+    out += "</g>\n</svg>\n";
+    return WriteFile(path, out, error);
+}
+
+bool WriteGanttPng(const GanttScene& scene, const string& path, wstring& error) {
+    Raster raster(scene.width, scene.height);
+    for (const GanttRect& r : scene.rects) {
+        raster.Fill(r.x1, r.y1, r.x2, r.y2, r.color);
+        if (r.outline) raster.Outline(r.x1, r.y1, r.x2, r.y2);
+    }
+    for (const GanttLine& l : scene.lines) raster.Line(l.x1, l.y1, l.x2, l.y2);
+    for (const GanttText& t : scene.texts) raster.Text(t.x, t.y, t.text);
+
+    // 每行前加滤波类型0
+    string pixels;
+    pixels.reserve((size_t)(scene.width * 3 + 1) * scene.height);
+    for (int y = 0; y < raster.Height(); y++) {
+        pixels.push_back(0);
+        pixels.append((const char*)raster.Row(y), (size_t)raster.Width() * 3);
+    }
+
+    string header;
+    PutBigEndian(header, (uint32_t)scene.width);
+    PutBigEndian(header, (uint32_t)scene.height);
+    header += string("\x08\x02\x00\x00\x00", 5);  // 8位RGB，无隔行
+    string out("\x89PNG\r\n\x1a\n", 8);
+    PutChunk(out, "IHDR", header);
+    PutChunk(out, "IDAT", Deflate(pixels, (size_t)raster.Width() * 3 + 1));
+    PutChunk(out, "IEND", string());
+    return WriteFile(path, out, error);
+}
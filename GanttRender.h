@@ -0,0 +1,82 @@
+// GanttRender.h
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ProcessSchedulingSimulator.h"
+
+// 甘特图绘制选项
+struct GanttOptions {
+    int width;            // 图片宽度（像素）
+    int height;           // 图片高度，0表示按泳道数自动确定
+    int lane_height;      // 自动高度时每条泳道的高度
+    int max_lanes_height; // 自动高度时泳道区域的最大高度，泳道更多时压缩到该高度
+    bool per_process;     // 每个进程一条泳道（默认每个CPU一条）
+    size_t legend_limit;  // 进程数不超过该值时列出图例
+
+    GanttOptions()
+        : width(1200), height(0), lane_height(30), max_lanes_height(4000),
+          per_process(false), legend_limit(32) {}
+};
+
+// 场景中的图元，坐标以左上角为原点，颜色为0xRRGGBB
+struct GanttRect {
+    int x1, y1, x2, y2;
+    uint32_t color;
+    bool outline;
+};
+
+struct GanttLine {
+    int x1, y1, x2, y2;
+};
+
+struct GanttText {
+    int x, y;             // 文字左上角
+    std::wstring text;
+};
+
+// 与平台无关的绘制结果，由SVG/PNG输出或Windows窗口绘制
+struct GanttScene {
+    int width, height;
+    std::vector<GanttRect> rects;
+    std::vector<GanttLine> lines;
+    std::vector<GanttText> texts;
+};
+
+// 估计的文字尺寸（等宽12像素字体），用于居中和剔除放不下的标签
+const int kGanttCharWidth = 7;
+const int kGanttTextHeight = 12;
+
+// 甘特图布局：把时间线映射为矩形，耗时与段数和像素数成正比
+// 宽度不少于1像素的段画成进程颜色的矩形；更窄的段按像素列累计占用时间，
+// 相邻且占用率档位相同的列合并为一条灰度密度带，百万段的时间线也只产生与宽度相当的图元。
+class GanttRenderer {
+public:
+    GanttRenderer(const std::vector<Timeline>& lanes, const std::vector<ProcessPCB>& processes);
+
+    GanttScene Layout(const GanttOptions& options);
+
+    // 进程颜色（按进程ID的黄金分割色相），计算结果缓存
+    uint32_t ProcessColor(int pid);
+
+private:
+    void BeginRow(GanttScene& scene, int y, int h);
+    void AddSegments(GanttScene& scene, const TimelineSegment* begin, const TimelineSegment* end);
+    void EndRow(GanttScene& scene, int lanes);
+
+    const std::vector<Timeline>& m_lanes;
+    const std::vector<ProcessPCB>& m_processes;
+    std::vector<uint32_t> m_palette;   // 按进程ID缓存的颜色，0表示尚未计算
+    std::vector<double> m_coverage;    // 当前行各像素列被窄段占用的时长（像素）
+    int m_left;                        // 时间0所在的横坐标
+    double m_scale;                    // 每个时间单位的像素数
+    size_t m_row_start;                // 当前行的第一个矩形
+    int m_row_y, m_row_h;
+};
+
+// 按文件扩展名（.svg或.png）输出
+bool WriteGantt(const GanttScene& scene, const std::string& path, std::wstring& error);
+bool WriteGanttSvg(const GanttScene& scene, const std::string& path, std::wstring& error);
+// PNG用内置的5x7点阵字体绘制ASCII文字（小写按大写绘制）
+bool WriteGanttPng(const GanttScene& scene, const std::string& path, std::wstring& error);
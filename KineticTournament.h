@@ -0,0 +1,160 @@
+// KineticTournament.h
+#pragma once
+
+#include <vector>
+#include <climits>
+#include <cstddef>
+
+// 动态锦标赛树：元素的排序键随时间线性变化时，维护当前时刻排在最前的元素
+// 每个内部节点保存子树的胜者和"证书"到期时刻（败者最早反超胜者的时刻），
+// 以及子树内最早的到期时刻。时间前进时只重算证书已到期的节点，其余节点不动。
+// 两条直线最多相交一次，因此每对元素最多引起一次重算。
+//
+// Rules 提供：
+//   bool Beats(const T& a, const T& b, long long t) const       t时刻a是否排在b之前
+//   long long FailTime(const T& winner, const T& loser, long long t) const
+//                                                               t时刻winner领先，返回loser最早反超的时刻，不会反超时返回LLONG_MAX
+//   int& SlotOf(const T& item) const                            元素自带的叶子位置字段，不在树中时为-1
+// 时间只能前进；插入、删除和取队首时传入当前时刻。
+template <typename T, typename Rules>
+class KineticTournament {
+public:
+    explicit KineticTournament(Rules rules = Rules())
+        : m_rules(rules), m_capacity(0), m_size(0), m_now(LLONG_MIN) {}
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+
+    void Insert(const T& item, long long now) {
+        Advance(now);
+        if (m_free.empty()) Grow();
+        int slot = m_free.back();
+        m_free.pop_back();
+        m_leaves[slot] = item;
+        m_rules.SlotOf(item) = slot;
+        m_nodes[m_capacity + slot].winner = slot;
+        m_size++;
+        UpdatePath(m_capacity + slot);
+    }
+
+    // 删除元素，不在树中时返回false
+    bool Remove(const T& item, long long now) {
+        int slot = m_rules.SlotOf(item);
+        if (slot < 0 || (size_t)slot >= m_capacity || m_nodes[m_capacity + slot].winner != slot) return false;
+        Advance(now);
+        m_rules.SlotOf(item) = -1;
+        m_nodes[m_capacity + slot].winner = -1;
+        m_free.push_back(slot);
+        m_size--;
+        UpdatePath(m_capacity + slot);
+        return true;
+    }
+
+    // now时刻排在最前的元素（树不得为空）
+    const T& Top(long long now) {
+        Advance(now);
+        return m_leaves[m_nodes[1].winner];
+    }
+
+    // now时刻不排在最前的某个元素（树中至少有两个元素），用于负载均衡时迁移
+    const T& NonTop(long long now) {
+        Advance(now);
+        int top = m_nodes[1].winner;
+        size_t i = 1;
+        while (i < m_capacity) {
+            size_t other = m_nodes[2 * i].winner == top ? 2 * i + 1 : 2 * i;
+            if (m_nodes[other].winner >= 0) return m_leaves[m_nodes[other].winner];
+            i = other ^ 1;
+        }
+        return m_leaves[top];
+    }
+
+    // 访问树中的每个元素（按叶子位置，不按先后）
+    template <typename F>
+    void ForEach(F visit) const {
+        for (size_t i = 0; i < m_capacity; i++) {
+            if (m_nodes[m_capacity + i].winner >= 0) visit(m_leaves[i]);
+        }
+    }
+
+    void Clear() {
+        for (size_t i = 0; i < m_capacity; i++) {
+            if (m_nodes[m_capacity + i].winner >= 0) m_rules.SlotOf(m_leaves[i]) = -1;
+        }
+        m_nodes.clear();
+        m_leaves.clear();
+        m_free.clear();
+        m_capacity = 0;
+        m_size = 0;
+        m_now = LLONG_MIN;
+    }
+
+    // 换用新的规则对象（树连同元素一起复制到别处后使用），新旧规则必须等价
+    void Rebind(Rules rules) { m_rules = rules; }
+
+private:
+    struct Node {
+        int winner;          // 胜者的叶子下标，子树为空时为-1
+        long long fail;      // 本节点证书的到期时刻
+        long long min_fail;  // 子树内最早的到期时刻
+    };
+
+    // 推进到now，重算所有到期的证书
+    void Advance(long long now) {
+        if (now > m_now) m_now = now;
+        if (m_capacity > 1 && m_nodes[1].min_fail <= m_now) Refresh(1);
+    }
+
+    void Refresh(size_t i) {
+        if (i >= m_capacity || m_nodes[i].min_fail > m_now) return;
+        Refresh(2 * i);
+        Refresh(2 * i + 1);
+        Recompute(i);
+    }
+
+    void Recompute(size_t i) {
+        Node& node = m_nodes[i];
+        const Node& left = m_nodes[2 * i];
+        const Node& right = m_nodes[2 * i + 1];
+        node.fail = LLONG_MAX;
+        if (left.winner < 0 || right.winner < 0) {
+            node.winner = left.winner < 0 ? right.winner : left.winner;
+        } else {
+            int winner = left.winner, loser = right.winner;
+            if (m_rules.Beats(m_leaves[loser], m_leaves[winner], m_now)) {
+                winner = right.winner;
+                loser = left.winner;
+            }
+            node.winner = winner;
+            node.fail = m_rules.FailTime(m_leaves[winner], m_leaves[loser], m_now);
+        }
+        node.min_fail = node.fail;
+        if (left.min_fail < node.min_fail) node.min_fail = left.min_fail;
+        if (right.min_fail < node.min_fail) node.min_fail = right.min_fail;
+    }
+
+    void UpdatePath(size_t i) {
+        for (i /= 2; i >= 1; i /= 2) Recompute(i);
+    }
+
+    // 叶子数翻倍，叶子下标不变，内部节点在当前时刻重建
+    void Grow() {
+        size_t old_capacity = m_capacity;
+        size_t capacity = old_capacity ? old_capacity * 2 : 16;
+        std::vector<Node> nodes(2 * capacity, Node{ -1, LLONG_MAX, LLONG_MAX });
+        for (size_t i = 0; i < old_capacity; i++) nodes[capacity + i] = m_nodes[old_capacity + i];
+        m_nodes.swap(nodes);
+        m_leaves.resize(capacity);
+        m_capacity = capacity;
+        for (size_t slot = capacity; slot-- > old_capacity; ) m_free.push_back((int)slot);
+        for (size_t i = capacity; --i >= 1; ) Recompute(i);
+    }
+
+    Rules m_rules;
+    std::vector<Node> m_nodes;   // 1为根，i的子节点为2i和2i+1，叶子从m_capacity开始
+    std::vector<T> m_leaves;
+    std::vector<int> m_free;     // 空闲的叶子下标
+    size_t m_capacity;
+    size_t m_size;
+    long long m_now;
+};
@@ -0,0 +1,30 @@
+// MappedFile.h
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+// 只读内存映射文件（Windows用MapViewOfFile，其他平台用mmap）
+// 只能映射普通文件；空文件打开成功但Data()为空指针
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool Open(const std::string& path);
+    void Close();
+
+    const char* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    const char* m_data;
+    size_t m_size;
+#ifdef _WIN32
+    void* m_file;
+    void* m_mapping;
+#endif
+};
@@ -0,0 +1,111 @@
+// MlfqQueue.h
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "TimingWheel.h"
+
+// 多级反馈队列：每一级一个先进先出的侵入式双向链表，另用位图记录非空的级别，
+// 取队首时用"找最低置位"指令得到最高的非空级别，入队、删除和取队首都是O(1)，与队列长度无关。
+// 级别数不超过64（位图为一个64位字），0为最高级。
+//
+// Links 提供：
+//   T& Prev(const T& item) const    元素自带的前驱字段
+//   T& Next(const T& item) const    元素自带的后继字段
+// none 表示空链接的值。
+template <typename T, typename Links>
+class MlfqQueue {
+public:
+    static const int kMaxLevels = 64;
+
+    MlfqQueue(Links links, T none, int levels = 1)
+        : m_links(links), m_none(none), m_bitmap(0), m_size(0) {
+        Reset(levels);
+    }
+
+    void Reset(int levels) {
+        m_head.assign(levels, m_none);
+        m_tail.assign(levels, m_none);
+        m_bitmap = 0;
+        m_size = 0;
+    }
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    int Levels() const { return (int)m_head.size(); }
+
+    // 换用新的链接字段访问对象（队列连同元素一起复制到别处后使用）
+    void Rebind(Links links) { m_links = links; }
+
+    // 加入第level级的队尾
+    void PushBack(const T& item, int level) {
+        m_links.Prev(item) = m_tail[level];
+        m_links.Next(item) = m_none;
+        if (m_tail[level] == m_none) m_head[level] = item;
+        else m_links.Next(m_tail[level]) = item;
+        m_tail[level] = item;
+        m_bitmap |= 1ULL << level;
+        m_size++;
+    }
+
+    // 从第level级中删除（调用方保证元素在该级中）
+    void Remove(const T& item, int level) {
+        T prev = m_links.Prev(item), next = m_links.Next(item);
+        if (prev == m_none) m_head[level] = next;
+        else m_links.Next(prev) = next;
+        if (next == m_none) m_tail[level] = prev;
+        else m_links.Prev(next) = prev;
+        if (m_head[level] == m_none) m_bitmap &= ~(1ULL << level);
+        m_size--;
+    }
+
+    // 最高非空级别，队列为空时返回Levels()
+    int TopLevel() const {
+        return m_bitmap == 0 ? Levels() : LowestSetBit(m_bitmap);
+    }
+
+    // 最高非空级别的队首，队列为空时返回none
+    T Top() const {
+        return m_bitmap == 0 ? m_none : m_head[LowestSetBit(m_bitmap)];
+    }
+
+    // 最低非空级别的队尾（最不急于调度的元素），队列为空时返回none；代价与级别数成正比
+    T Back() const {
+        for (int level = Levels(); level-- > 0; ) {
+            if (m_tail[level] != m_none) return m_tail[level];
+        }
+        return m_none;
+    }
+
+    // 按级别从高到低、同级从头到尾访问每个元素
+    template <typename F>
+    void ForEach(F visit) const {
+        for (int level = 0; level < Levels(); level++) {
+            for (T item = m_head[level]; item != m_none; item = m_links.Next(item)) visit(item);
+        }
+    }
+
+    // 所有级别按级别从高到低依次接到第0级之后，代价与级别数成正比
+    void MergeToTop() {
+        for (int level = 1; level < Levels(); level++) {
+            if (m_head[level] == m_none) continue;
+            if (m_tail[0] == m_none) {
+                m_head[0] = m_head[level];
+            } else {
+                m_links.Next(m_tail[0]) = m_head[level];
+                m_links.Prev(m_head[level]) = m_tail[0];
+            }
+            m_tail[0] = m_tail[level];
+            m_head[level] = m_tail[level] = m_none;
+        }
+        m_bitmap = m_size > 0 ? 1 : 0;
+    }
+
+private:
+    Links m_links;
+    T m_none;
+    std::vector<T> m_head, m_tail;
+    uint64_t m_bitmap;   // 第i位为1表示第i级非空
+    size_t m_size;
+};
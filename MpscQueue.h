@@ -0,0 +1,74 @@
+// MpscQueue.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// 有界的多生产者单消费者队列（Vyukov的环形缓冲区算法）
+// 每个槽带一个序号：序号等于写位置时槽空闲，等于写位置+1时已写入。
+// 生产者用一次CAS领取写位置，写入后发布序号；消费者只读写自己的读位置，不需要原子的读-改-写。
+// 没有锁也不分配内存；满时TryPush返回false，由调用方决定等待还是丢弃。
+// 某个生产者领取位置后被挂起时，消费者要等它发布后才能取到之后的元素（各生产者自身的顺序不变）。
+template <typename T>
+class MpscQueue {
+public:
+    // 容量向上取为2的幂
+    explicit MpscQueue(size_t capacity) : m_head(0) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        m_mask = size - 1;
+        m_cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; i++) m_cells[i].seq.store(i, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_relaxed);
+    }
+
+    size_t Capacity() const { return m_mask + 1; }
+
+    // 任意线程调用；成功时item被移走
+    bool TryPush(T& item) {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;  // 满：该槽还没被消费者取走
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(item);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只由消费者线程调用
+    bool TryPop(T& out) {
+        Cell& cell = m_cells[m_head & m_mask];
+        if (cell.seq.load(std::memory_order_acquire) != m_head + 1) return false;
+        out = std::move(cell.value);
+        cell.seq.store(m_head + m_mask + 1, std::memory_order_release);
+        m_head++;
+        return true;
+    }
+
+private:
+    MpscQueue(const MpscQueue&);
+    MpscQueue& operator=(const MpscQueue&);
+
+    struct Cell {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_tail;  // 生产者共享的写位置
+    alignas(64) size_t m_head;               // 消费者的读位置
+};
@@ -0,0 +1,289 @@
+#include "stdafx.h"
+#include "OnlineScheduler.h"
+#include "WorkloadLoader.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <thread>
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+// 模拟时钟的上限：RunUntil(目标+1)和进程的结束时间都不超出int
+const long long kMaxTime = INT_MAX - 1;
+
+// 进程的服务时间和全部IO时间之和
+long long WorkOf(const ProcessPCB& pro, const vector<IoBurst>& bursts) {
+    long long work = (long long)pro.service_time + max(0, pro.io_time);
+    for (uint32_t i = 0; i < pro.burst_count; i++) work += bursts[pro.burst_offset + i].time;
+    return work;
+}
+
+// 与读取负载时相同的检查；后续IO须在第一次IO之后且按开始位置排列
+bool ValidArrival(const OnlineArrival& arrival) {
+    const ProcessPCB& pro = arrival.pcb;
+    if (pro.service_time <= 0 || pro.io_time < 0) return false;
+    if (!arrival.bursts.empty() && (pro.io_start < 0 || pro.io_time <= 0)) return false;
+    int previous = pro.io_start;
+    for (const IoBurst& io : arrival.bursts) {
+        if (io.time <= 0 || io.start < previous) return false;
+        previous = io.start;
+    }
+    return true;
+}
+
+} // namespace
+
+OnlineScheduler::OnlineScheduler(ProcessScheduler& scheduler, SchedulePolicy policy, long long tick_ns, size_t capacity)
+    : m_scheduler(scheduler), m_policy(policy), m_tick_ns(max(0LL, tick_ns)), m_start(0), m_queue(capacity),
+      m_producers(0), m_invalid(0), m_arrivals(0), m_rejected(0), m_outstanding(0), m_finished_seen(0) {}
+
+void OnlineScheduler::Reserve(size_t processes) {
+    ProcessScheduler& s = m_scheduler;
+    s.pcb_pool.reserve(processes);
+    s.arrive_queue.reserve(processes);
+    s.finish_queue.reserve(processes);
+    m_submitted.reserve(processes);
+}
+
+long long OnlineScheduler::Now() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void OnlineScheduler::Submit(OnlineArrival& arrival) {
+    arrival.submitted = Now();
+    while (!m_queue.TryPush(arrival)) this_thread::yield();
+}
+
+// 接收一个进程：编号、把后续IO接到burst_arena末尾，按到达时间插入arrive_queue尚未到达的部分
+void OnlineScheduler::Admit(OnlineArrival& arrival) {
+    ProcessScheduler& s = m_scheduler;
+    ProcessPCB& pro = arrival.pcb;
+    // 按提交时刻对应的时刻到达，引擎落后时不会把一段时间内的到达挤到同一时刻
+    if (m_tick_ns > 0)
+        pro.arrive_time = (int)max((long long)pro.arrive_time, min(kMaxTime - 1, (arrival.submitted - m_start) / m_tick_ns));
+    pro.arrive_time = max(pro.arrive_time, s.current_time);
+    pro.burst_offset = (uint32_t)s.burst_arena.size();
+    pro.burst_count = (uint32_t)arrival.bursts.size();
+    if (!ValidArrival(arrival)) {
+        m_rejected++;
+        return;
+    }
+    long long work = (long long)pro.service_time + pro.io_time;
+    for (const IoBurst& io : arrival.bursts) work += io.time;
+    // 所有进程结束前的时间不超过最晚到达时间加上未完成进程的全部服务和IO时间（见CheckTimeRange）
+    if (pro.arrive_time + m_outstanding + work > kMaxTime) {
+        m_rejected++;
+        return;
+    }
+    m_outstanding += work;
+    s.burst_arena.insert(s.burst_arena.end(), arrival.bursts.begin(), arrival.bursts.end());
+    s.InitProcess(pro, (int)++m_arrivals);
+
+    PcbHandle h = (PcbHandle)s.pcb_pool.size();
+    int arrive_time = pro.arrive_time;
+    s.pcb_pool.push_back(std::move(pro));
+    m_submitted.push_back(arrival.submitted);
+    vector<PcbHandle>& queue = s.arrive_queue;
+    if (queue.size() == s.arrive_pos || s.Pcb(queue.back()).arrive_time <= arrive_time) {
+        queue.push_back(h);
+    } else {
+        auto pos = upper_bound(queue.begin() + s.arrive_pos, queue.end(), arrive_time,
+            [&s](int time, PcbHandle other) { return time < s.Pcb(other).arrive_time; });
+        queue.insert(pos, h);
+    }
+}
+
+// arrive_queue中[decided_from, arrive_pos)的进程在本轮进入了就绪队列，记下决策延迟；
+// 本轮完成的进程从未完成工作量中扣除
+void OnlineScheduler::Settle(size_t decided_from, long long now) {
+    ProcessScheduler& s = m_scheduler;
+    for (size_t i = decided_from; i < s.arrive_pos; i++)
+        m_latency.Record((uint64_t)max(0LL, now - m_submitted[s.arrive_queue[i]]));
+    for (; m_finished_seen < s.finish_queue.size(); m_finished_seen++)
+        m_outstanding -= WorkOf(s.Pcb(s.finish_queue[m_finished_seen]), s.burst_arena);
+}
+
+OnlineStatus OnlineScheduler::Status(long long start) const {
+    const ProcessScheduler& s = m_scheduler;
+    OnlineStatus status;
+    status.wall_seconds = (Now() - start) / 1e9;
+    status.sim_time = s.current_time;
+    status.arrivals = m_arrivals;
+    status.rejected = m_rejected;
+    status.finished = (long long)s.finish_queue.size();
+    status.ready = 0;
+    for (int q = 0; q < (int)s.ready_queues.size(); q++) status.ready += s.QueueSize(q);
+    status.running = 0;
+    for (const CpuState& cpu : s.cpus) status.running += cpu.running != kNoProcess;
+    status.decided = m_latency.Count();
+    status.latency_p50 = m_latency.ValueAtQuantile(0.5) / 1e3;
+    status.latency_p99 = m_latency.ValueAtQuantile(0.99) / 1e3;
+    status.latency_p999 = m_latency.ValueAtQuantile(0.999) / 1e3;
+    status.latency_max = m_latency.ValueAtQuantile(1.0) / 1e3;
+    status.stats = s.ComputeStatistics();
+    return status;
+}
+
+void OnlineScheduler::Run(const function<void(const OnlineStatus&)>& report, double report_seconds) {
+    ProcessScheduler& s = m_scheduler;
+    s.pcb_pool.clear();
+    s.burst_arena.clear();
+    s.arrive_queue.clear();
+    s.arrive_pos = 0;
+    s.finish_queue.clear();
+    s.Start(m_policy);
+    m_arrivals = m_rejected = m_outstanding = 0;
+    m_finished_seen = 0;
+    m_submitted.clear();
+    m_latency = HdrHistogram();
+
+    m_start = Now();
+    const long long start = m_start;
+    const long long interval = report_seconds > 0 ? (long long)(report_seconds * 1e9) : LLONG_MAX;
+    long long next_report = interval == LLONG_MAX ? LLONG_MAX : start + interval;
+    OnlineArrival arrival;
+    while (true) {
+        // 先读生产者数：读到0时之前的提交都已可见，下面取空队列后就不会再有新进程
+        bool open = m_producers.load(memory_order_acquire) > 0;
+
+        // 墙上时间对应的时刻；全部空闲时时钟直接拨过去，新进程按此刻到达
+        long long target = LLONG_MAX - 1;
+        if (m_tick_ns > 0) {
+            target = min(kMaxTime - 1, (Now() - start) / m_tick_ns);
+            if (target > s.current_time && !s.HasPending()) s.Advance(target - s.current_time);
+        }
+        // 每轮最多取一个队列容量的进程，生产者持续提交时引擎也能推进
+        size_t received = 0;
+        while (received < m_queue.Capacity() && m_queue.TryPop(arrival)) {
+            Admit(arrival);
+            received++;
+        }
+
+        size_t decided_from = s.arrive_pos;
+        s.RunUntil(target + 1);
+        Settle(decided_from, Now());
+
+        long long now = Now();
+        if (now >= next_report) {
+            report(Status(start));
+            next_report = now + interval;
+        }
+        bool idle = !s.HasPending();
+        if (!open && !received && idle) break;
+        // 已追上墙上时间且没有新进程时让出CPU
+        if (!received && (idle || s.current_time > target)) this_thread::yield();
+    }
+    if (report) report(Status(start));
+}
+
+void ProduceGenerated(OnlineScheduler& online, const vector<ProcessPCB>& processes, const vector<IoBurst>& bursts,
+    size_t begin, size_t step, double rate) {
+    using clock = chrono::steady_clock;
+    const clock::time_point start = clock::now();
+    const double period = rate > 0 ? 1e9 * step / rate : 0;  // 本线程相邻两次提交的间隔（纳秒）
+    OnlineArrival arrival;
+    long long n = 0;
+    for (size_t i = begin; i < processes.size(); i += step, n++) {
+        if (period > 0) {
+            clock::time_point due = start + chrono::nanoseconds((long long)(n * period));
+            while (clock::now() < due) this_thread::yield();
+        }
+        const ProcessPCB& from = processes[i];
+        ProcessPCB& pro = arrival.pcb;
+        pro.name = from.name;
+        pro.arrive_time = 0;
+        pro.service_time = from.service_time;
+        pro.priority = from.priority;
+        pro.io_start = from.io_start;
+        pro.io_time = from.io_time;
+        arrival.bursts.assign(bursts.begin() + from.burst_offset, bursts.begin() + from.burst_offset + from.burst_count);
+        online.Submit(arrival);
+    }
+}
+
+void ProduceStream(OnlineScheduler& online, FILE* fp) {
+    WorkloadLoader loader;
+    vector<ProcessPCB> parsed;
+    vector<IoBurst> bursts;
+    string line;
+    char buffer[4096];
+    OnlineArrival arrival;
+    while (fgets(buffer, sizeof(buffer), fp)) {
+        line += buffer;
+        if (line.back() != '\n' && !feof(fp)) continue;  // 行比缓冲区长，接着读
+        parsed.clear();
+        bursts.clear();
+        if (!loader.LoadBuffer(line.data(), line.size(), parsed, bursts)) {
+            online.CountInvalid();
+            loader.ClearError();
+        } else {
+            for (ProcessPCB& pro : parsed) {
+                arrival.bursts.assign(bursts.begin() + pro.burst_offset, bursts.begin() + pro.burst_offset + pro.burst_count);
+                arrival.pcb = std::move(pro);
+                online.Submit(arrival);
+            }
+        }
+        line.clear();
+    }
+}
+
+#ifdef _WIN32
+bool ServeUnixSocket(OnlineScheduler&, const string&, wstring& error) {
+    error = L"Windows下不支持Unix域套接字，请改用管道（-）";
+    return false;
+}
+#else
+bool ServeUnixSocket(OnlineScheduler& online, const string& path, wstring& error) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        error = L"套接字路径过长";
+        return false;
+    }
+    path.copy(address.sun_path, path.size());
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path.c_str());
+    if (listener < 0 || bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 16) != 0) {
+        if (listener >= 0) close(listener);
+        error = L"无法监听套接字：" + wstring(path.begin(), path.end());
+        return false;
+    }
+
+    // 每个连接一个生产者线程；有过连接且全部关闭后停止监听
+    atomic<int> active(0);
+    bool connected = false;
+    vector<thread> readers;
+    while (!connected || active.load() > 0) {
+        pollfd waiting = { listener, POLLIN, 0 };
+        if (poll(&waiting, 1, 100) <= 0) continue;
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) continue;
+        FILE* fp = fdopen(fd, "r");
+        if (!fp) {
+            close(fd);
+            continue;
+        }
+        connected = true;
+        active++;
+        online.AddProducer();
+        readers.emplace_back([&online, &active, fp]() {
+            ProduceStream(online, fp);
+            fclose(fp);
+            online.RemoveProducer();
+            active--;
+        });
+    }
+    for (thread& reader : readers) reader.join();
+    close(listener);
+    unlink(path.c_str());
+    return true;
+}
+#endif
@@ -0,0 +1,100 @@
+// OnlineScheduler.h
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+#include "ProcessSchedulingSimulator.h"
+#include "MpscQueue.h"
+#include "Statistics.h"
+
+// 在线提交的一个进程：pcb中只使用输入字段（进程名、到达时间、服务时间、优先级、IO开始时间和IO阻塞时间），
+// 进程ID由引擎按接收顺序从1编号；与墙上时间同步时不早于提交时刻对应的时刻，且不早于引擎当前时刻
+struct OnlineArrival {
+    ProcessPCB pcb;
+    std::vector<IoBurst> bursts;  // 第二次及以后的IO（pcb.burst_offset为其中的起点）
+    long long submitted;          // 提交时刻（steady_clock纳秒），由Submit填写
+};
+
+// 运行中定期发布的状态
+struct OnlineStatus {
+    double wall_seconds;          // 开始后的墙上时间
+    int sim_time;                 // 模拟时钟
+    long long arrivals;           // 已接收的进程
+    long long rejected;           // 字段无效或会使模拟时钟溢出而拒绝的进程
+    long long finished;
+    size_t ready, running;
+    long long decided;            // 已进入就绪队列、计入决策延迟的进程
+    double latency_p50, latency_p99, latency_p999, latency_max;  // 决策延迟（微秒）
+    ScheduleStatistics stats;     // 已完成进程的平均指标
+};
+
+// 在线调度：模拟开始时没有负载，生产者线程（或读取管道、套接字的线程）随时提交进程，
+// 经无锁的多生产者单消费者队列交给引擎线程。引擎线程每一轮先取空队列，把新进程按到达时间插入
+// arrive_queue尚未到达的部分，再由RunUntil推进到墙上时间对应的时刻，新进程照常经MoveArrivedToReady进入就绪队列。
+// 模拟时钟按tick_ns纳秒一个时间单位与墙上时间同步：引擎领先时等待，落后时批量追赶；
+// 全部空闲时时钟直接拨到墙上时间。tick_ns为0时不与墙上时间同步，每轮把已知的进程全部模拟完。
+// 决策延迟为提交到该进程进入就绪队列、所在时刻的调度完成之间的墙上时间。
+// 调度决策经调度器的事件日志（event_log）发布，运行统计按间隔交给回调。
+// 模拟时钟为int，tick_ns为1000时约可连续运行35分钟；PCB和甘特图随到达的进程增长，不回收。
+class OnlineScheduler {
+public:
+    // scheduler提供CPU配置和算法参数，运行时其中原有的负载和结果被清空
+    OnlineScheduler(ProcessScheduler& scheduler, SchedulePolicy policy, long long tick_ns, size_t capacity = 1 << 16);
+
+    // 生产者登记和注销：登记的生产者都注销、队列取空并且进程全部完成后Run返回。
+    // 应在Run开始前或其他生产者仍登记时登记，否则Run可能已经返回
+    void AddProducer() { m_producers.fetch_add(1, std::memory_order_acq_rel); }
+    void RemoveProducer() { m_producers.fetch_sub(1, std::memory_order_acq_rel); }
+
+    // 预知进程数时预先分配PCB等数组，避免运行中扩容（百万个进程时扩容的复制约占引擎时间的三分之一）
+    void Reserve(size_t processes);
+
+    // 任意线程调用：记下提交时刻后放入队列，队列满时让出CPU等待
+    void Submit(OnlineArrival& arrival);
+
+    // 生产者读到的无效输入（如格式错误的行）
+    void CountInvalid() { m_invalid.fetch_add(1, std::memory_order_relaxed); }
+    long long Invalid() const { return m_invalid.load(std::memory_order_relaxed); }
+
+    // 引擎线程：每隔report_seconds秒（墙上时间）及结束时调用report
+    void Run(const std::function<void(const OnlineStatus&)>& report, double report_seconds);
+
+    const HdrHistogram& Latency() const { return m_latency; }
+
+private:
+    static long long Now();
+    void Admit(OnlineArrival& arrival);
+    void Settle(size_t decided_from, long long now);
+    OnlineStatus Status(long long start) const;
+
+    ProcessScheduler& m_scheduler;
+    SchedulePolicy m_policy;
+    long long m_tick_ns;
+    long long m_start;              // Run开始的时刻（steady_clock纳秒）
+    MpscQueue<OnlineArrival> m_queue;
+    std::atomic<int> m_producers;
+    std::atomic<long long> m_invalid;
+    long long m_arrivals, m_rejected;
+    long long m_outstanding;        // 未完成进程的服务和IO时间之和，用于保证时钟不溢出
+    size_t m_finished_seen;         // finish_queue中已从m_outstanding扣除的进程数
+    std::vector<long long> m_submitted;  // 各PCB句柄的提交时刻
+    HdrHistogram m_latency;         // 决策延迟（纳秒）
+};
+
+// 以下生产者函数都不登记生产者：调用方在启动线程前AddProducer，函数返回后RemoveProducer
+
+// 生产者：按rate（每秒进程数，0为不限速）从processes[begin]起每隔step个依次提交，到达时间按当前时刻。
+// 多个线程各取不同的begin即可并发提交同一负载
+void ProduceGenerated(OnlineScheduler& online, const std::vector<ProcessPCB>& processes,
+    const std::vector<IoBurst>& bursts, size_t begin, size_t step, double rate);
+
+// 生产者：逐行读取与负载文件相同格式的CSV/TSV（见WorkloadLoader.h）并提交，到达时间为相对开始的时刻；
+// 格式错误的行跳过并计入Invalid()，读到文件末尾时返回
+void ProduceStream(OnlineScheduler& online, FILE* fp);
+
+// 在Unix域套接字path上接受连接，每个连接由一个线程按ProduceStream读取；
+// 至少有过一个连接且所有连接都关闭后返回；各连接在监听期间登记为生产者（Windows下不支持）
+bool ServeUnixSocket(OnlineScheduler& online, const std::string& path, std::wstring& error);
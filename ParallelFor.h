@@ -0,0 +1,26 @@
+// ParallelFor.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// 用threads个线程（0表示按硬件线程数）执行task(0)到task(count-1)
+// 各线程从共享计数器领取下一个任务，耗时不均的任务会由先空闲的线程接手。
+// task在多个线程中并发调用，只应写入各自下标对应的结果。
+template <typename Task>
+void ParallelFor(size_t count, int threads, Task task) {
+    if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    if (threads < 1) threads = 1;
+    if ((size_t)threads > count) threads = (int)count;
+
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) task(i);
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) workers.emplace_back(work);
+    work();
+    for (std::thread& worker : workers) worker.join();
+}
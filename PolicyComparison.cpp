@@ -0,0 +1,58 @@
+#include "stdafx.h"
+#include "PolicyComparison.h"
+#include "ParallelFor.h"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+// 与SelectPolicy菜单中的英文名一致
+const wchar_t* PolicyTitle(int policy) {
+    static const wchar_t* titles[] = { L"", L"FCFS", L"Round-Robin", L"DynamicPriority", L"SJF", L"HRRN", L"SRTF", L"MLFQ", L"CFS" };
+    return policy >= 1 && policy <= kLastPolicy ? titles[policy] : L"?";
+}
+
+PolicyComparison::PolicyComparison(const ProcessScheduler& workload) : m_workload(workload) {}
+
+// 每个算法一个任务，由线程池中先空闲的线程领取
+void PolicyComparison::Run(const vector<int>& policies, int threads, vector<PolicyOutcome>& out) const {
+    out.assign(policies.size(), PolicyOutcome());
+    ParallelFor(policies.size(), threads, [&](size_t i) {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        ProcessScheduler scheduler;
+        scheduler.quiet = true;
+        scheduler.CopyWorkload(m_workload);
+        scheduler.Simulate((SchedulePolicy)policies[i]);
+        out[i] = Summarize(scheduler, policies[i], chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    });
+}
+
+PolicyOutcome PolicyComparison::Summarize(const ProcessScheduler& scheduler, int policy, double wall_seconds) {
+    PolicyOutcome outcome;
+    outcome.policy = policy;
+    outcome.stats = scheduler.ComputeStatistics();
+    outcome.p99_response = scheduler.finish_stats.all.response.Quantile(0.99);
+    outcome.p99_turnaround = scheduler.finish_stats.all.turnaround.Quantile(0.99);
+    outcome.end_time = scheduler.current_time;
+    outcome.wall_seconds = wall_seconds;
+    return outcome;
+}
+
+// 输出比较表
+void PolicyComparison::PrintTable(const vector<PolicyOutcome>& outcomes) {
+    wcout << L"\n算法比较：\n";
+    wcout << L"          算法|  平均等待|  平均周转|平均带权周转|  平均响应|  p99响应|  p99周转|  完成时刻|  耗时(秒)\n";
+    for (const PolicyOutcome& outcome : outcomes) {
+        wcout << setw(16) << PolicyTitle(outcome.policy)
+            << fixed << setprecision(2)
+            << setw(10) << outcome.stats.avg_wait
+            << setw(10) << outcome.stats.avg_turnaround
+            << setw(12) << outcome.stats.avg_weighted
+            << setw(10) << outcome.stats.avg_response
+            << setw(10) << outcome.p99_response
+            << setw(10) << outcome.p99_turnaround
+            << setw(10) << outcome.end_time
+            << setprecision(3) << setw(10) << outcome.wall_seconds << L"\n";
+    }
+}
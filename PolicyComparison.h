@@ -0,0 +1,37 @@
+// PolicyComparison.h
+#pragma once
+
+#include <vector>
+#include "ProcessSchedulingSimulator.h"
+
+// 算法的英文名，用于表格输出
+const wchar_t* PolicyTitle(int policy);
+
+// 单个算法的比较结果
+struct PolicyOutcome {
+    int policy;
+    ScheduleStatistics stats;
+    double p99_response, p99_turnaround;
+    int end_time;          // 最后一个进程完成的时刻
+    double wall_seconds;
+};
+
+// 在同一份负载上并行比较多个调度算法
+// 负载只读取和排序一次，保存在一个不做模拟的调度器中，各算法在自己的线程里
+// 用独立的调度器从中复制输入字段后模拟（不复制进程名），互不共享可变状态。
+class PolicyComparison {
+public:
+    explicit PolicyComparison(const ProcessScheduler& workload);
+
+    // 按policies的顺序返回结果，threads为0时按硬件线程数
+    void Run(const std::vector<int>& policies, int threads, std::vector<PolicyOutcome>& out) const;
+
+    // 各算法的统计指标并排输出为一张表
+    static void PrintTable(const std::vector<PolicyOutcome>& outcomes);
+
+    // 模拟结束的调度器的比较结果
+    static PolicyOutcome Summarize(const ProcessScheduler& scheduler, int policy, double wall_seconds);
+
+private:
+    const ProcessScheduler& m_workload;
+};
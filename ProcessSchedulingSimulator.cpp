@@ -2,16 +2,20 @@
 #define _UNICODE
 #include "stdafx.h"
 #include "ProcessSchedulingSimulator.h"
-#include "GanttChart.h"
+#include "WorkloadLoader.h"
+#include "BinaryFormat.h"
+#include "WorkloadGenerator.h"
+#include "Cfs.h"
+#include "ResultCache.h"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
 #include <memory>
 #include <vector>
 #include <string>
-#include <windows.h>
-#include <io.h>
-#include <fcntl.h>
+#include <climits>
+#include <cmath>
+#include <unordered_map>
 
 using namespace std;
 
@@ -19,33 +23,93 @@ using namespace std;
 const wchar_t* StateStrings[] = { L"执行", L"就绪", L"完成", L"未到达", L"阻塞" };
 
 // 构造函数
-ProcessScheduler::ProcessScheduler() : running_process(nullptr) {}
+ProcessScheduler::ProcessScheduler()
+    : arrive_pos(0), cpu_count(1), per_cpu_queues(false), balance_interval(0), work_stealing(false), next_balance_time(0),
+      policy(PolicyFCFS), current_time(0), current_round(0),
+      wait_counted_round(0), ready_counter(0), time_quantum(2), mlfq_quanta({ 2, 4, 8 }), mlfq_boost(50),
+      next_boost_time(0), mlfq_epoch(0), cfs_latency(16), cfs_min_granularity(2),
+      fair_clock(0), fair_weight(0), fair_count(0), quiet(false),
+      event_log(nullptr), trace_level(EventLevelSchedule), cache_limit(256ULL << 20), step_count(0) {
+    ResetCpus();
+}
 
 // 析构函数
 ProcessScheduler::~ProcessScheduler() {}
 
-// 主入口
-void ProcessScheduler::Run() {
-    InputProcesses();  // 输入进程信息
+// 主入口：指定负载文件时从文件读取进程，指定算法编号时不再询问，指定结果文件时保存模拟结果
+// 返回是否完成了模拟（甘特图由调用方的前端显示）
+bool ProcessScheduler::Run(const string& workload_path, int selected, const string& results_path) {
+    if (workload_path.empty()) {
+        InputProcesses();  // 输入进程信息
+    } else if (!LoadWorkload(workload_path)) {
+        return false;
+    }
+    wstring error;
+    if (!CheckTimeRange(error)) {
+        wcout << error << L"\n";
+        return false;
+    }
     PrintAll(-1);      // 打印初始状态
 
-    int policy = SelectPolicy();  // 选择调度算法
+    int policy = (selected >= 1 && selected <= kLastPolicy) ? selected : SelectPolicy();  // 选择调度算法
+
+    // 同一负载和参数模拟过的直接取缓存的结果（没有调度日志）
+    ResultCache cache(cache_path, cache_limit);
+    ResultKey key = {};
+    if (!cache_path.empty()) {
+        key = ResultCache::Key(*this, (SchedulePolicy)policy);
+        if (cache.Load(key, *this)) {
+            wcout << L"从结果缓存读取，未重新模拟\n";
+            if (!quiet) PrintAll(current_time);
+            if (!results_path.empty()) SaveResults(results_path);
+            PrintStatistics();
+            return true;
+        }
+        if (!cache.Error().empty()) wcout << cache.Error() << L"\n";
+    }
+
+    // 模拟过程中只记录定长的事件，结束后再格式化输出
+    EventLog log(trace_level);
+    bool tracing = trace_level != EventLevelOff && (!quiet || !trace_path.empty());
+    if (tracing) {
+        if (trace_path.empty()) {
+            log.Start(policy, cpu_count);
+        } else if (!log.Start(policy, cpu_count, trace_path, error)) {
+            wcout << error << L"\n";
+            return false;
+        }
+        event_log = &log;
+    }
     switch (policy) {
     case 1: FCFS(); break;
     case 2: RoundRobin(); break;
     case 3: DynamicPriority(); break;
     case 4: SJF(); break;
+    case 5: HRRN(); break;
+    case 6: SRTF(); break;
+    case 7: MLFQ(); break;
+    case 8: CFS(); break;
     default: FCFS(); break;
     }
+    event_log = nullptr;
+    log.Stop();
+    if (!quiet) {
+        if (tracing && trace_path.empty()) PrintEvents(log);
+        PrintAll(current_time);
+    }
 
-    ShowGanttChart();  // 显示甘特图
+    if (!results_path.empty()) SaveResults(results_path);
+    if (!cache_path.empty() && !cache.Store(key, *this)) wcout << cache.Error() << L"\n";
     PrintStatistics(); // 输出统计信息
+    return true;
 }
 
-// 显示甘特图
-void ProcessScheduler::ShowGanttChart() {
-    GanttChart chart;
-    chart.Show(gantt_data, finish_queue);
+// 读取保存的模拟结果并显示，不重新模拟
+bool ProcessScheduler::ShowResults(const string& results_path) {
+    if (!LoadResults(results_path)) return false;
+    PrintAll(current_time);
+    PrintStatistics();
+    return true;
 }
 
 // 比较到达时间
@@ -54,7 +118,7 @@ bool ProcessScheduler::CompareArriveTime(const ProcessPCB& a, const ProcessPCB&
 }
 
 // 比较优先级
-bool ProcessScheduler::ComparePriority(const ProcessPCB& a, const ProcessPCB& b) {
+bool ProcessScheduler::ComparePriority(const ProcessPCB& a, const ProcessPCB& b) const {
     if (a.priority != b.priority) {
         return a.priority > b.priority;
     } else {
@@ -71,11 +135,13 @@ int ProcessScheduler::SelectPolicy() {
     wcout << L"4. 最短作业优先(SJF)\n";
     wcout << L"5. 高响应比优先(HRRN)\n";
     wcout << L"6. 最短剩余时间优先(SRTF)\n";
-    int n;
+    wcout << L"7. 多级反馈队列(MLFQ)\n";
+    wcout << L"8. 完全公平调度(CFS)\n";
+    int n = 1;
     wcout << L"请输入算法编号: ";
     while (wcin >> n) {
-        if (n < 1 || n > 6) {
-            wcout << L"请输入有效编号(1-6): ";
+        if (n < 1 || n > kLastPolicy) {
+            wcout << L"请输入有效编号(1-8): ";
         } else {
             break;
         }
@@ -93,53 +159,245 @@ void ProcessScheduler::InputProcesses() {
         ProcessPCB pro;
         wcout << L"\n请输入第" << i << L"个进程的信息（进程名 到达时间 服务时间 优先级 IO开始时间 IO阻塞时间）:\n";
         wcin >> pro.name >> pro.arrive_time >> pro.service_time >> pro.priority >> pro.io_start >> pro.io_time;
+        pro.burst_offset = pro.burst_count = 0;
+        InitProcess(pro, i);
+        pcb_pool.push_back(pro);
+    }
+    BuildArriveQueue(false);
+}
+
+// 从CSV/TSV文件（"-"表示标准输入）或二进制负载文件批量读取进程，
+// 也可以是"gen:"开头的合成负载描述
+bool ProcessScheduler::LoadWorkload(const string& path) {
+    size_t first = pcb_pool.size(), first_burst = burst_arena.size();
+    bool binary = IsBinaryFile(path);
+    bool ok, sorted = false;
+    wstring error;
+    if (WorkloadGenerator::IsSpec(path)) {
+        GeneratorConfig config;
+        ok = WorkloadGenerator::ParseSpec(path, config, error);
+        if (ok) ok = WorkloadGenerator(config).Generate(pcb_pool, burst_arena, error);
+        sorted = true;
+    } else if (binary) {
+        ok = LoadWorkloadBinary(path, pcb_pool, burst_arena, sorted, error);
+    } else {
+        WorkloadLoader loader;
+        ok = loader.LoadFile(path, pcb_pool, burst_arena);
+        sorted = loader.IsSorted();
+        error = loader.Error();
+    }
+    if (!ok) {
+        pcb_pool.resize(first);
+        burst_arena.resize(first_burst);
+        wcout << L"读取负载失败：" << error << L"\n";
+        return false;
+    }
+    // 二进制负载保留文件中的进程ID
+    for (size_t i = first; i < pcb_pool.size(); i++)
+        InitProcess(pcb_pool[i], binary ? pcb_pool[i].ID : (int)i + 1);
+    BuildArriveQueue(sorted && first == 0);
+    if (!quiet) wcout << L"已读取" << pcb_pool.size() - first << L"个进程\n";
+    return true;
+}
+
+// 保存模拟结果（完成进程和甘特图）到二进制文件
+bool ProcessScheduler::SaveResults(const string& path) {
+    wstring error;
+    if (!SaveResultsBinary(path, pcb_pool, finish_queue, timelines, error)) {
+        wcout << L"保存结果失败：" << error << L"\n";
+        return false;
+    }
+    wcout << L"模拟结果已保存\n";
+    return true;
+}
+
+// 读取二进制结果文件，恢复完成队列和甘特图
+bool ProcessScheduler::LoadResults(const string& path) {
+    BinaryReader reader;
+    if (!reader.Open(path, BinaryResults)) {
+        wcout << L"读取结果失败：" << reader.Error() << L"\n";
+        return false;
+    }
+    wstring error;
+    vector<int32_t> ids(reader.Count());
+    for (size_t i = 0; i < reader.Count(); i++) ids[i] = reader.Results()[i].id;
+    if (!CheckProcessIds(ids, error)) {
+        wcout << L"读取结果失败：" << error << L"\n";
+        return false;
+    }
+    pcb_pool.clear();
+    burst_arena.clear();
+    finish_queue.clear();
+    finish_stats.Clear();
+    arrive_queue.clear();
+    arrive_pos = 0;
+
+    const ResultRecord* records = reader.Results();
+    pcb_pool.resize(reader.Count());
+    for (size_t i = 0; i < reader.Count(); i++) {
+        const ResultRecord& rec = records[i];
+        ProcessPCB& pro = pcb_pool[i];
+        InitProcess(pro, rec.id);
+        reader.Name(rec.name_offset, rec.name_length, pro.name);
+        pro.arrive_time = rec.arrive_time;
+        pro.service_time = rec.service_time;
+        pro.priority = rec.priority;
+        pro.io_start = rec.io_start;
+        pro.io_time = rec.io_time;
+        pro.all_time = 0;
+        pro.cpu_time = rec.service_time;
+        pro.start_time = rec.start_time;
+        pro.end_time = rec.end_time;
+        pro.wait_time = rec.wait_time;
+        pro.response_time = rec.response_time;
+        pro.turnaround_time = rec.turnaround_time;
+        pro.io_count = rec.io_count;
+        pro.state = Finish;
+        pro.base_priority = rec.priority;
+        finish_queue.push_back((PcbHandle)i);
+        finish_stats.Record(pro);
+    }
+
+    // 泳道数由段记录中最大的CPU编号决定
+    const SegmentRecord* segments = reader.Segments();
+    int lanes = 1;
+    for (size_t i = 0; i < reader.SegmentCount(); i++) {
+        if (segments[i].cpu < 0 || segments[i].cpu >= kMaxCpus) {
+            wcout << L"读取结果失败：甘特图段的CPU编号无效\n";
+            return false;
+        }
+        lanes = max(lanes, segments[i].cpu + 1);
+    }
+    ConfigureCpus(lanes, false, 0, false);
+    long long end_time = 0;
+    for (size_t i = 0; i < reader.SegmentCount(); i++) {
+        const SegmentRecord& seg = segments[i];
+        if (seg.pid == kIdlePid) continue;
+        timelines[seg.cpu].Append(seg.pid, seg.start, seg.end - seg.start);
+        end_time = max(end_time, timelines[seg.cpu].EndTime());
+    }
+    current_time = (int)end_time;
+    return true;
+}
+
+// 初始化进程的运行状态
+void ProcessScheduler::InitProcess(ProcessPCB& pro, int id) {
+    pro.ID = id;
+    pro.all_time = pro.service_time;
+    pro.cpu_time = 0;
+    pro.start_time = -1;
+    pro.end_time = -1;
+    pro.wait_time = 0;
+    pro.response_time = -1;
+    pro.turnaround_time = 0;
+    pro.state = Unarrive;
+    pro.io_count = (pro.io_time > 0 ? 1 : 0) + pro.burst_count;
+    pro.burst_next = 0;
+    pro.ready_round = 0;
+    pro.ready_seq = 0;
+    pro.ready_pos = -1;
+    pro.cpu = -1;
+    pro.hrrn_slot = -1;
+    pro.base_priority = pro.priority;
+    pro.mlfq_prev = pro.mlfq_next = kNoProcess;
+    pro.mlfq_level = 0;
+    pro.mlfq_epoch = 0;
+    pro.vruntime = 0;
+    pro.fair_start = pro.fair_share = 0;
+}
+
+// 检查模拟时钟不会溢出：任一时刻总有CPU在运行或有进程在IO（否则就绪进程会被调度），
+// 因此所有进程结束前的时间不超过最晚到达时间加上全部服务时间和IO时间。
+// 进程的时间字段和时钟都是int，超出范围的负载在模拟前拒绝
+bool ProcessScheduler::CheckTimeRange(wstring& error) const {
+    long long bound = 0, latest = 0;
+    for (const ProcessPCB& pro : pcb_pool) {
+        latest = max<long long>(latest, pro.arrive_time);
+        bound += (long long)pro.service_time + max(0, pro.io_time);
+        for (uint32_t i = 0; i < pro.burst_count; i++) bound += burst_arena[pro.burst_offset + i].time;
+        if (bound > INT_MAX) break;
+    }
+    if (latest + bound > INT_MAX) {
+        error = L"负载的总时长（最晚到达时间加全部服务和IO时间）超出int范围，无法模拟";
+        return false;
+    }
+    return true;
+}
 
-        // 初始化
-        pro.ID = i;
-        pro.all_time = pro.service_time;
-        pro.cpu_time = 0;
-        pro.start_time = -1;
-        pro.end_time = -1;
-        pro.wait_time = 0;
-        pro.response_time = -1;
-        pro.turnaround_time = 0;
-        pro.state = Unarrive;
-        pro.io_count = (pro.io_time > 0) ? 1 : 0;
-        arrive_queue.push_back(pro);
-    }
-
-    // 按到达时间排序
-    sort(arrive_queue.begin(), arrive_queue.end(),
-        [this](const ProcessPCB& a, const ProcessPCB& b) {
-            return CompareArriveTime(a, b);
+// 建立到达队列，sorted为真表示PCB池已按到达时间排列，可跳过排序
+void ProcessScheduler::BuildArriveQueue(bool sorted) {
+    arrive_queue.resize(pcb_pool.size());
+    for (size_t i = 0; i < pcb_pool.size(); i++) arrive_queue[i] = (PcbHandle)i;
+    arrive_pos = 0;
+    if (sorted) return;
+
+    // 按到达时间排序（同时到达的保持输入顺序）
+    stable_sort(arrive_queue.begin(), arrive_queue.end(),
+        [this](PcbHandle a, PcbHandle b) {
+            return CompareArriveTime(Pcb(a), Pcb(b));
         });
 }
 
+// 从尚未模拟的调度器复制负载的输入字段、到达顺序和CPU配置，不复制进程名；
+// 只读取source，多个线程可以同时从同一个source复制
+void ProcessScheduler::CopyWorkload(const ProcessScheduler& source) {
+    pcb_pool.clear();
+    pcb_pool.resize(source.pcb_pool.size());
+    for (size_t i = 0; i < pcb_pool.size(); i++) {
+        const ProcessPCB& from = source.pcb_pool[i];
+        ProcessPCB& pro = pcb_pool[i];
+        pro.arrive_time = from.arrive_time;
+        pro.service_time = from.service_time;
+        pro.priority = from.priority;
+        pro.io_start = from.io_start;
+        pro.io_time = from.io_time;
+        pro.burst_offset = from.burst_offset;
+        pro.burst_count = from.burst_count;
+        InitProcess(pro, from.ID);
+    }
+    burst_arena = source.burst_arena;
+    arrive_queue = source.arrive_queue;
+    arrive_pos = 0;
+    finish_queue.clear();
+    time_quantum = source.time_quantum;
+    mlfq_quanta = source.mlfq_quanta;
+    mlfq_boost = source.mlfq_boost;
+    cfs_latency = source.cfs_latency;
+    cfs_min_granularity = source.cfs_min_granularity;
+    ConfigureCpus(source.cpu_count, source.per_cpu_queues, source.balance_interval, source.work_stealing);
+}
+
 // 到达队列进程转入就绪队列
 void ProcessScheduler::MoveArrivedToReady(int current_time) {
-    while (!arrive_queue.empty()) {
-        ProcessPCB& pro = arrive_queue.front();
-        if (pro.arrive_time <= current_time) {
-            pro.state = Ready;
-            ready_queue.push_back(pro);
-            arrive_queue.erase(arrive_queue.begin());
+    while (arrive_pos < arrive_queue.size()) {
+        PcbHandle h = arrive_queue[arrive_pos];
+        if (Pcb(h).arrive_time <= current_time) {
+            PushReady(h, current_round);
+            Trace(EventArrive, Pcb(h), current_time, -1);
+            arrive_pos++;
         } else {
             break;
         }
     }
 }
 
-// 更新阻塞队列
+// 更新阻塞队列：只取出本轮IO完成的进程，按阻塞先后转入就绪队列
+// 有后续IO的进程从burst_arena取出下一次IO；MLFQ中因IO让出CPU的进程提升一级
 void ProcessScheduler::UpdateBlockedQueue() {
-    for (auto it = blocked_queue.begin(); it != blocked_queue.end(); ) {
-        it->io_time--;
-        if (it->io_time <= 0) {
-            it->state = Ready;
-            ready_queue.push_back(*it);
-            it = blocked_queue.erase(it);
+    woken.clear();
+    blocked_queue.PopDue(current_round, woken);
+    for (PcbHandle h : woken) {
+        ProcessPCB& pro = Pcb(h);
+        if (pro.burst_next < pro.burst_count) {
+            const IoBurst& next = burst_arena[pro.burst_offset + pro.burst_next++];
+            pro.io_start = next.start;
+            pro.io_time = next.time;
         } else {
-            ++it;
+            pro.io_time = 0;
         }
+        if (policy == PolicyMLFQ) SetMlfqLevel(pro, max(0, MlfqLevel(pro) - 1));
+        PushReady(h, current_round);
+        Trace(EventWake, pro, current_time, -1);
     }
 }
 
@@ -147,11 +405,18 @@ void ProcessScheduler::UpdateBlockedQueue() {
 void ProcessScheduler::PrintProcess(const ProcessPCB* pro) {
     if (!pro) return;
 
+    // 就绪进程的等待时间（以及HRRN的响应比）由入队轮次推算
+    int wait_time = pro->wait_time, priority = pro->priority;
+    if (pro->state == Ready) {
+        wait_time = ReadyWait(*pro);
+        if (policy == PolicyHRRN) priority = HrrnKey(*pro, current_round);
+    }
+
     wcout << setw(4) << pro->ID
-        << setw(10) << pro->name
+        << setw(10) << DisplayName(*pro)
         << setw(10) << pro->arrive_time
         << setw(10) << pro->service_time
-        << setw(8) << pro->priority
+        << setw(8) << priority
         << setw(10) << StateStrings[pro->state];
 
     if (pro->start_time == -1) {
@@ -168,11 +433,11 @@ void ProcessScheduler::PrintProcess(const ProcessPCB* pro) {
         float weighted_time = (float)(pro->end_time - pro->arrive_time) / (float)pro->service_time;
         wcout << setw(10) << (pro->end_time - pro->arrive_time)
             << setw(10) << fixed << setprecision(2) << weighted_time
-            << setw(10) << pro->wait_time
+            << setw(10) << wait_time
             << setw(10) << pro->response_time << L"\n";
     } else {
         wcout << setw(10) << L"--" << setw(10) << L"--"
-            << setw(10) << pro->wait_time
+            << setw(10) << wait_time
             << setw(10) << pro->response_time << L"\n";
     }
 }
@@ -187,475 +452,845 @@ void ProcessScheduler::PrintAll(int current) {
 
     wcout << L"进程ID|进程名|到达时间|服务时间|优先级|  状态  |开始时间|结束时间|剩余时间|周转时间|带权周转|等待时间|响应时间\n";
 
-    if (running_process) {
-        PrintProcess(running_process.get());
+    for (const CpuState& cpu : cpus) {
+        if (cpu.running != kNoProcess) PrintProcess(&Pcb(cpu.running));
     }
 
-    for (const auto& pro : ready_queue) {
-        PrintProcess(&pro);
+    // 就绪队列按调度顺序输出，本轮刚被抢占回队的进程排在最后
+    vector<PcbHandle> ready_order;
+    for (int q = 0; q < (int)ready_queues.size(); q++) QueueMembers(q, ready_order);
+    sort(ready_order.begin(), ready_order.end(),
+        [this](PcbHandle a, PcbHandle b) {
+            bool a_late = Pcb(a).ready_round > current_round, b_late = Pcb(b).ready_round > current_round;
+            if (a_late != b_late) return b_late;
+            return CompareReady(Pcb(a), Pcb(b));
+        });
+    for (PcbHandle h : ready_order) {
+        PrintProcess(&Pcb(h));
     }
 
-    for (const auto& pro : finish_queue) {
-        PrintProcess(&pro);
+    for (PcbHandle h : finish_queue) {
+        PrintProcess(&Pcb(h));
     }
 
-    for (const auto& pro : arrive_queue) {
-        PrintProcess(&pro);
+    for (size_t i = arrive_pos; i < arrive_queue.size(); i++) {
+        PrintProcess(&Pcb(arrive_queue[i]));
     }
 
-    for (const auto& pro : blocked_queue) {
-        PrintProcess(&pro);
+    blocked_queue.ForEach([this](PcbHandle h) {
+        PrintProcess(&Pcb(h));
+    });
+}
+
+// 按原调度日志的格式输出记录的事件
+void ProcessScheduler::PrintEvents(const EventLog& log) const {
+    unordered_map<int, const ProcessPCB*> by_id;
+    for (const ProcessPCB& pro : pcb_pool) by_id[pro.ID] = &pro;
+    ExportEventsText(log.Header(), log.Records().data(), log.Records().size(), trace_level,
+        [this, &by_id](int id) { return DisplayName(*by_id[id]); }, wcout);
+}
+
+// 进程名，合成负载中的进程没有名字时用P加ID代替
+wstring ProcessScheduler::DisplayName(const ProcessPCB& pro) const {
+    return pro.name.empty() ? L"P" + to_wstring(pro.ID) : pro.name;
+}
+
+// 加入就绪队列，counted_from为开始计入等待时间的轮次
+// CFS中新到达和IO完成的进程（不是从CPU上换下的）在入队前放置虚拟运行时间
+void ProcessScheduler::PushReady(PcbHandle h, long long counted_from) {
+    ProcessPCB& pro = Pcb(h);
+    int q = PickQueue(pro);
+    if (policy == PolicyCFS && pro.state != Executing) {
+        PlaceCfs(pro, q);
+        FairEnter(pro);
     }
+    pro.state = Ready;
+    pro.ready_round = counted_from;
+    pro.ready_seq = ready_counter++;
+    QueuePush(q, h);
 }
 
-// 输出调度日志
-void ProcessScheduler::Log(const wstring& msg, int current_time) {
-    wcout << L"[时间" << current_time << L"] " << msg << L"\n";
+// 进程加入第q个就绪队列：HRRN只加入选择树，MLFQ只加入所在级别的队尾，不经过就绪堆
+void ProcessScheduler::QueuePush(int q, PcbHandle h) {
+    if (policy == PolicyHRRN) hrrn_index[q].Insert(h, current_round);
+    else if (policy == PolicyMLFQ) mlfq_index[q].PushBack(h, MlfqLevel(Pcb(h)));
+    else ready_queues[q].Push(h);
+    if (policy == PolicyCFS) cfs_load[q] += CfsWeight(Pcb(h).priority);
 }
 
-// 先来先服务
-void ProcessScheduler::FCFS() {
-    int current_time = 0;
-    bool need_schedule = true;
-    gantt_data.clear();
-    running_process.reset();
+// 进程离开第q个就绪队列
+void ProcessScheduler::QueueRemove(int q, PcbHandle h) {
+    if (policy == PolicyHRRN) hrrn_index[q].Remove(h, current_round);
+    else if (policy == PolicyMLFQ) mlfq_index[q].Remove(h, MlfqLevel(Pcb(h)));
+    else ready_queues[q].Remove(h);
+    if (policy == PolicyCFS) cfs_load[q] -= CfsWeight(Pcb(h).priority);
+}
 
-    while (true) {
-        if (!running_process && arrive_queue.empty() && ready_queue.empty() && blocked_queue.empty()) break;
-
-        MoveArrivedToReady(current_time);
-        UpdateBlockedQueue();
-
-        // 更新等待时间
-        for (auto& pro : ready_queue) pro.wait_time++;
-
-        if (need_schedule && !ready_queue.empty()) {
-            running_process = std::unique_ptr<ProcessPCB>(new ProcessPCB(ready_queue[0]));
-            ready_queue.erase(ready_queue.begin());
-            if (running_process->start_time == -1)
-                running_process->start_time = current_time;
-            if (running_process->response_time == -1)
-                running_process->response_time = current_time - running_process->arrive_time;
-            running_process->state = Executing;
-            need_schedule = false;
-            Log(L"进程" + running_process->name + L"（P" + to_wstring(running_process->ID) + L"）开始执行，优先级" + to_wstring(running_process->priority) + L"，剩余时间" + to_wstring(running_process->all_time), current_time);
-            PrintAll(current_time);
-        }
+// 第q个就绪队列中的进程数
+size_t ProcessScheduler::QueueSize(int q) const {
+    if (policy == PolicyHRRN) return hrrn_index[q].size();
+    if (policy == PolicyMLFQ) return mlfq_index[q].size();
+    return ready_queues[q].size();
+}
 
-        if (running_process) {
-            gantt_data.push_back(make_pair(running_process->ID, current_time));
-
-            // IO阻塞
-            if (running_process->cpu_time == running_process->io_start && running_process->io_time > 0) {
-                running_process->state = Blocked;
-                blocked_queue.push_back(*running_process);
-                Log(L"进程" + running_process->name + L"（P" + to_wstring(running_process->ID) + L"）进入IO，阻塞" + to_wstring(running_process->io_time) + L"个时间片", current_time);
-                running_process.reset();
-                need_schedule = true;
-                continue;
-            }
+// 把第q个就绪队列中的进程追加到out（不按调度顺序）
+void ProcessScheduler::QueueMembers(int q, vector<PcbHandle>& out) const {
+    auto append = [&out](PcbHandle h) { out.push_back(h); };
+    if (policy == PolicyHRRN) hrrn_index[q].ForEach(append);
+    else if (policy == PolicyMLFQ) mlfq_index[q].ForEach(append);
+    else out.insert(out.end(), ready_queues[q].begin(), ready_queues[q].end());
+}
 
-            running_process->cpu_time++;
-            running_process->all_time--;
-
-            if (running_process->all_time == 0) {
-                running_process->end_time = current_time + 1;
-                running_process->state = Finish;
-                running_process->turnaround_time = running_process->end_time - running_process->arrive_time;
-                finish_queue.push_back(*running_process);
-                Log(L"进程" + running_process->name + L"（P" + to_wstring(running_process->ID) + L"）完成", current_time + 1);
-                running_process.reset();
-                need_schedule = true;
-            }
+// 选择进程加入的就绪队列：运行过的进程回到上次所在CPU的队列，
+// 新到达的进程进入负载（排队数加运行中的进程）最轻的CPU
+int ProcessScheduler::PickQueue(const ProcessPCB& pro) const {
+    if (!per_cpu_queues) return 0;
+    if (pro.cpu >= 0) return pro.cpu;
+    int best = 0;
+    size_t best_load = SIZE_MAX;
+    for (int c = 0; c < cpu_count; c++) {
+        size_t load = QueueSize(c) + (cpus[c].running != kNoProcess ? 1 : 0);
+        if (load < best_load) {
+            best = c;
+            best_load = load;
         }
-        current_time++;
     }
-    PrintAll(current_time);
+    return best;
 }
 
-// 时间片轮转
-void ProcessScheduler::RoundRobin() {
-    int current_time = 0;
-    bool need_schedule = true;
-    const int time_quantum = 2;
-    int time_slice = 0;
-    gantt_data.clear();
-    running_process.reset();
-
+// 周期性负载均衡：从最长的队列向最短的队列迁移进程，直到长度差不超过1
+// 每次迁移堆数组的最后一个元素：它是叶子，删除代价最小，且在队列多于一个进程时不会是队首；
+// 但不保证是最晚被调度的。MLFQ迁移最低非空级别的队尾，HRRN迁移选择树中某个不在最前的进程。迁移保留原有的等待时间和入队次序，CFS时保留相对于队列最小虚拟运行时间的差
+void ProcessScheduler::Balance() {
     while (true) {
-        if (!running_process && arrive_queue.empty() && ready_queue.empty() && blocked_queue.empty()) break;
-
-        MoveArrivedToReady(current_time);
-        UpdateBlockedQueue();
-
-        for (auto& pro : ready_queue) pro.wait_time++;
-
-        if (need_schedule && !ready_queue.empty()) {
-            running_process = std::unique_ptr<ProcessPCB>(new ProcessPCB(ready_queue[0]));
-            ready_queue.erase(ready_queue.begin());
-            if (running_process->start_time == -1)
-                running_process->start_time = current_time;
-            if (running_process->response_time == -1)
-                running_process->response_time = current_time - running_process->arrive_time;
-            running_process->state = Executing;
-            time_slice = 0;
-            need_schedule = false;
-            Log(L"进程" + running_process->name + L"（P" + to_wstring(running_process->ID) + L"）开始执行，优先级" + to_wstring(running_process->priority) + L"，剩余时间" + to_wstring(running_process->all_time), current_time);
-            PrintAll(current_time);
+        int longest = 0, shortest = 0;
+        for (int q = 1; q < (int)ready_queues.size(); q++) {
+            if (QueueSize(q) > QueueSize(longest)) longest = q;
+            if (QueueSize(q) < QueueSize(shortest)) shortest = q;
         }
+        if (QueueSize(longest) <= QueueSize(shortest) + 1) break;
+        PcbHandle h;
+        if (policy == PolicyHRRN) h = hrrn_index[longest].NonTop(current_round);
+        else if (policy == PolicyMLFQ) h = mlfq_index[longest].Back();
+        else h = *(ready_queues[longest].end() - 1);
+        QueueRemove((int)longest, h);
+        if (policy == PolicyCFS)
+            Pcb(h).vruntime += CfsMinVruntime((int)shortest) - CfsMinVruntime((int)longest);
+        Pcb(h).cpu = (int)shortest;
+        QueuePush((int)shortest, h);
+    }
+}
 
-        if (running_process) {
-            gantt_data.push_back(make_pair(running_process->ID, current_time));
+// 空闲CPU从最长的就绪队列取走其队首进程，返回是否取到
+bool ProcessScheduler::Steal(int c) {
+    int victim = -1;
+    for (int q = 0; q < (int)ready_queues.size(); q++) {
+        if (q == c || QueueSize(q) == 0) continue;
+        if (victim < 0 || QueueSize(q) > QueueSize(victim)) victim = q;
+    }
+    if (victim < 0) return false;
+    PcbHandle h = SelectNext(victim);
+    QueueRemove(victim, h);
+    if (policy == PolicyCFS) Pcb(h).vruntime += CfsMinVruntime(cpus[c].queue) - CfsMinVruntime(victim);
+    Pcb(h).cpu = c;
+    QueuePush(cpus[c].queue, h);
+    Trace(EventMigrate, Pcb(h), current_time, c, victim);
+    return true;
+}
 
-            if (running_process->cpu_time == running_process->io_start && running_process->io_time > 0) {
-                running_process->state = Blocked;
-                blocked_queue.push_back(*running_process);
-                Log(L"进程" + running_process->name + L"（P" + to_wstring(running_process->ID) + L"）进入IO，阻塞" + to_wstring(running_process->io_time) + L"个时间片", current_time);
-                running_process.reset();
-                need_schedule = true;
-                continue;
-            }
+// 就绪进程截至目前的等待时间
+int ProcessScheduler::ReadyWait(const ProcessPCB& pro) const {
+    return pro.wait_time + (int)max(0LL, wait_counted_round - pro.ready_round);
+}
 
-            running_process->cpu_time++;
-            running_process->all_time--;
-            time_slice++;
-
-            if (running_process->all_time == 0) {
-                running_process->end_time = current_time + 1;
-                running_process->state = Finish;
-                running_process->turnaround_time = running_process->end_time - running_process->arrive_time;
-                finish_queue.push_back(*running_process);
-                Log(L"进程" + running_process->name + L"（P" + to_wstring(running_process->ID) + L"）完成", current_time + 1);
-                running_process.reset();
-                need_schedule = true;
-            } else if (time_slice == time_quantum) {
-                running_process->state = Ready;
-                ready_queue.push_back(*running_process);
-                Log(L"进程" + running_process->name + L"（P" + to_wstring(running_process->ID) + L"）时间片用尽，回到就绪队列", current_time + 1);
-                running_process.reset();
-                need_schedule = true;
-            }
-        }
-        current_time++;
+// HRRN在round轮开始时的响应比放大10000倍取整，只用于显示和事件日志（超出int时取INT_MAX）
+int ProcessScheduler::HrrnKey(const ProcessPCB& pro, long long round) const {
+    long long wait = pro.wait_time + (round - pro.ready_round);
+    double response_ratio = (double)(wait + pro.service_time) / pro.service_time;
+    return response_ratio * 10000 >= INT_MAX ? INT_MAX : static_cast<int>(response_ratio * 10000);
+}
+
+namespace {
+
+// 128位无符号数，用于精确比较两个响应比
+struct Wide {
+    uint64_t hi, lo;
+    bool operator<(const Wide& other) const { return hi != other.hi ? hi < other.hi : lo < other.lo; }
+};
+
+Wide MulWide(uint64_t a, uint32_t b) {
+    uint64_t low = (a & 0xFFFFFFFFu) * b;
+    uint64_t mid = (a >> 32) * b;
+    Wide r;
+    r.lo = low + (mid << 32);
+    r.hi = (mid >> 32) + (r.lo < low ? 1 : 0);
+    return r;
+}
+
+} // namespace
+
+// HRRN在round轮的先后：响应比(wait+s)/s较高者优先，比较wait_a*s_b与wait_b*s_a，不做浮点取整。
+// 响应比相同时与逐轮稳定排序一致：两者上一轮都在队列中时，上一轮领先的（服务时间较长的）优先；
+// 否则先入队者优先
+bool ProcessScheduler::HrrnBefore(const ProcessPCB& a, const ProcessPCB& b, long long round) const {
+    uint64_t wait_a = (uint64_t)(a.wait_time + (round - a.ready_round));
+    uint64_t wait_b = (uint64_t)(b.wait_time + (round - b.ready_round));
+    Wide ka = MulWide(wait_a, (uint32_t)b.service_time), kb = MulWide(wait_b, (uint32_t)a.service_time);
+    if (kb < ka) return true;
+    if (ka < kb) return false;
+    if (round > max(a.ready_round, b.ready_round) && a.service_time != b.service_time)
+        return a.service_time > b.service_time;
+    if (a.ready_round != b.ready_round) return a.ready_round < b.ready_round;
+    return a.ready_seq < b.ready_seq;
+}
+
+// round轮winner领先时，loser最早在哪一轮反超；只有服务时间更短（响应比增长更快）的才可能反超
+long long ProcessScheduler::HrrnOvertake(const ProcessPCB& winner, const ProcessPCB& loser, long long round) const {
+    if (loser.service_time >= winner.service_time) return LLONG_MAX;
+
+    // 先用浮点数估计交点，再用精确比较修正：找出loser领先的第一轮
+    long long base_w = winner.wait_time - winner.ready_round, base_l = loser.wait_time - loser.ready_round;
+    long double cross = ((long double)base_w * loser.service_time - (long double)base_l * winner.service_time) /
+        (winner.service_time - loser.service_time);
+    const long long limit = 1LL << 62;
+    if (cross >= (long double)limit) return LLONG_MAX;
+    long long guess = max(round + 1, (long long)floorl(cross) + 1);
+
+    long long lo = round;  // lo轮loser不领先，hi轮loser领先
+    long long hi = guess;
+    if (guess - 2 > round && !HrrnBefore(loser, winner, guess - 2)) lo = guess - 2;
+    for (long long step = 1; !HrrnBefore(loser, winner, hi); step *= 2) {
+        lo = hi;
+        if (hi >= limit - step) return LLONG_MAX;
+        hi += step;
     }
-    PrintAll(current_time);
+    while (hi - lo > 1) {
+        long long mid = lo + (hi - lo) / 2;
+        if (HrrnBefore(loser, winner, mid)) hi = mid;
+        else lo = mid;
+    }
+    return hi;
 }
 
-// 动态优先级
-void ProcessScheduler::DynamicPriority() {
-    int current_time = 0;
-    bool need_schedule = true;
-    gantt_data.clear();
-    running_process.reset();
+bool HrrnRules::Beats(PcbHandle a, PcbHandle b, long long round) const {
+    return owner->HrrnBefore(owner->Pcb(a), owner->Pcb(b), round);
+}
 
-    while (true) {
-        if (!running_process && arrive_queue.empty() && ready_queue.empty() && blocked_queue.empty()) break;
+long long HrrnRules::FailTime(PcbHandle winner, PcbHandle loser, long long round) const {
+    return owner->HrrnOvertake(owner->Pcb(winner), owner->Pcb(loser), round);
+}
 
-        MoveArrivedToReady(current_time);
-        UpdateBlockedQueue();
+int& HrrnRules::SlotOf(PcbHandle h) const {
+    return owner->Pcb(h).hrrn_slot;
+}
 
-        if (!ready_queue.empty()) {
-            sort(ready_queue.begin(), ready_queue.end(),
-                [this](const ProcessPCB& a, const ProcessPCB& b) {
-                    return this->ComparePriority(a, b);
-                });
-        }
+PcbHandle& MlfqLinks::Prev(PcbHandle h) const {
+    return owner->Pcb(h).mlfq_prev;
+}
 
-        for (auto& pro : ready_queue) pro.wait_time++;
-
-        if (need_schedule && !ready_queue.empty()) {
-            running_process = std::unique_ptr<ProcessPCB>(new ProcessPCB(ready_queue[0]));
-            ready_queue.erase(ready_queue.begin());
-            if (running_process->start_time == -1)
-                running_process->start_time = current_time;
-            if (running_process->response_time == -1)
-                running_process->response_time = current_time - running_process->arrive_time;
-            running_process->state = Executing;
-            need_schedule = false;
-            Log(L"进程" + running_process->name + L"（P" + to_wstring(running_process->ID) + L"）开始执行，优先级" + to_wstring(running_process->priority) + L"，剩余时间" + to_wstring(running_process->all_time), current_time);
-            PrintAll(current_time);
-        }
+PcbHandle& MlfqLinks::Next(PcbHandle h) const {
+    return owner->Pcb(h).mlfq_next;
+}
 
-        if (running_process) {
-            gantt_data.push_back(make_pair(running_process->ID, current_time));
+// 设置MLFQ级别（不在就绪队列中时调用），并记为属于当前提升周期
+void ProcessScheduler::SetMlfqLevel(ProcessPCB& pro, int level) {
+    pro.mlfq_level = level;
+    pro.mlfq_epoch = mlfq_epoch;
+}
 
-            if (running_process->cpu_time == running_process->io_start && running_process->io_time > 0) {
-                running_process->state = Blocked;
-                blocked_queue.push_back(*running_process);
-                Log(L"进程" + running_process->name + L"（P" + to_wstring(running_process->ID) + L"）进入IO，阻塞" + to_wstring(running_process->io_time) + L"个时间片", current_time);
-                running_process.reset();
-                need_schedule = true;
-                continue;
-            }
+// 周期性提升：就绪进程的各级链表整体接到0级之后；
+// 运行和阻塞的进程不逐个修改，提升周期加一后它们记录的级别作废，视为0级
+void ProcessScheduler::BoostMlfq() {
+    for (MlfqIndex& index : mlfq_index) index.MergeToTop();
+    mlfq_epoch++;
+    for (CpuState& cpu : cpus) cpu.time_slice = 0;
+}
 
-            running_process->cpu_time++;
-            running_process->all_time--;
-
-            if (running_process->all_time == 0) {
-                running_process->end_time = current_time + 1;
-                running_process->state = Finish;
-                running_process->turnaround_time = running_process->end_time - running_process->arrive_time;
-                finish_queue.push_back(*running_process);
-                Log(L"进程" + running_process->name + L"（P" + to_wstring(running_process->ID) + L"）完成", current_time + 1);
-                running_process.reset();
-                need_schedule = true;
-            } else {
-                if (running_process->priority > 1) running_process->priority--;
-                if (!ready_queue.empty() && ready_queue[0].priority >= running_process->priority) {
-                    running_process->state = Ready;
-                    ready_queue.push_back(*running_process);
-                    Log(L"进程" + running_process->name + L"（P" + to_wstring(running_process->ID) + L"）被抢占，回到就绪队列", current_time + 1);
-                    running_process.reset();
-                    need_schedule = true;
-                } else {
-                    need_schedule = false;
-                }
-            }
-        }
-        current_time++;
+// 第q个就绪队列的最小虚拟运行时间：取队首和在该队列上运行的进程中较小者，且不回退
+// 全局队列时遍历各CPU，每CPU队列时只看对应的CPU
+long long ProcessScheduler::CfsMinVruntime(int q) {
+    long long lowest = LLONG_MAX;
+    if (!ready_queues[q].empty()) lowest = Pcb(ready_queues[q].Top()).vruntime;
+    int first = per_cpu_queues ? q : 0, last = per_cpu_queues ? q + 1 : cpu_count;
+    for (int c = first; c < last; c++) {
+        if (cpus[c].running != kNoProcess) lowest = min(lowest, Pcb(cpus[c].running).vruntime);
     }
-    PrintAll(current_time);
+    if (lowest != LLONG_MAX) cfs_min_vruntime[q] = max(cfs_min_vruntime[q], lowest);
+    return cfs_min_vruntime[q];
 }
 
-// 最短作业优先（SJF）
-void ProcessScheduler::SJF() {
-    int current_time = 0;
-    bool need_schedule = true;
-    gantt_data.clear();
-    running_process.reset();
+// 放置加入第q个队列的进程：新进程从队列的最小虚拟运行时间开始；
+// IO完成的进程最多获得半个目标延迟的补偿，长时间阻塞不会积累过多的优势
+void ProcessScheduler::PlaceCfs(ProcessPCB& pro, int q) {
+    long long base = CfsMinVruntime(q);
+    if (pro.state == Unarrive) pro.vruntime = base;
+    else pro.vruntime = max(pro.vruntime, base - ((long long)cfs_latency << kCfsShift) / 2);
+}
 
-    while (true) {
-        if (!running_process && arrive_queue.empty() && ready_queue.empty() && blocked_queue.empty()) break;
+// 调度周期为目标延迟，可运行进程多于 目标延迟/最小粒度 时按每个进程一个最小粒度延长；
+// 进程按权重分得周期的一部分，不少于最小粒度（pro已离开队列）
+int ProcessScheduler::CfsSlice(int q, const ProcessPCB& pro) const {
+    long long running = (long long)ready_queues[q].size() + 1;
+    long long weight = CfsWeight(pro.priority);
+    long long period = max<long long>(cfs_latency, running * cfs_min_granularity);
+    long long slice = period * weight / (cfs_load[q] + weight);
+    return (int)min<long long>(INT_MAX, max<long long>(cfs_min_granularity, slice));
+}
 
-        MoveArrivedToReady(current_time);
-        UpdateBlockedQueue();
+// 进程变为可运行：记下公平时钟的起点
+void ProcessScheduler::FairEnter(ProcessPCB& pro) {
+    fair_weight += CfsWeight(pro.priority);
+    fair_count++;
+    pro.fair_start = fair_clock;
+}
 
-        // 按剩余服务时间排序
-        if (!ready_queue.empty()) {
-            sort(ready_queue.begin(), ready_queue.end(),
-                [](const ProcessPCB& a, const ProcessPCB& b) {
-                    return a.all_time < b.all_time;
-                });
-        }
+// 进程离开可运行状态：累计这段时间按权重应得的CPU时间
+void ProcessScheduler::FairLeave(ProcessPCB& pro) {
+    int weight = CfsWeight(pro.priority);
+    fair_weight -= weight;
+    fair_count--;
+    pro.fair_share += weight * (fair_clock - pro.fair_start);
+}
 
-        for (auto& pro : ready_queue) pro.wait_time++;
-
-        if (need_schedule && !ready_queue.empty()) {
-            running_process = std::unique_ptr<ProcessPCB>(new ProcessPCB(ready_queue[0]));
-            ready_queue.erase(ready_queue.begin());
-            if (running_process->start_time == -1)
-                running_process->start_time = current_time;
-            if (running_process->response_time == -1)
-                running_process->response_time = current_time - running_process->arrive_time;
-            running_process->state = Executing;
-            need_schedule = false;
-            Log(L"进程" + running_process->name + L"（P" + to_wstring(running_process->ID) + L"）开始执行，服务时间" + to_wstring(running_process->service_time) + L"，剩余时间" + to_wstring(running_process->all_time), current_time);
-            PrintAll(current_time);
-        }
+// 公平时钟前进n个时间单位：可运行进程按权重平分忙碌的CPU（多CPU时不考虑单个进程最多占一个CPU的上限）
+// 之后结算本时刻完成的进程
+void ProcessScheduler::AdvanceFairClock(int n) {
+    if (fair_count > 0) fair_clock += (double)n * min(cpu_count, fair_count) / fair_weight;
+    for (PcbHandle h : fair_leaving) FairLeave(Pcb(h));
+    fair_leaving.clear();
+}
 
-        if (running_process) {
-            gantt_data.push_back(make_pair(running_process->ID, current_time));
+// 就绪队列排序规则，键值相同时按入队先后
+bool ProcessScheduler::CompareReady(const ProcessPCB& a, const ProcessPCB& b) const {
+    switch (policy) {
+    case PolicyDynamicPriority:
+        if (a.priority != b.priority || a.arrive_time != b.arrive_time) return ComparePriority(a, b);
+        break;
+    case PolicySJF:
+    case PolicySRTF:
+        if (a.all_time != b.all_time) return a.all_time < b.all_time;
+        break;
+    case PolicyHRRN:
+        return HrrnBefore(a, b, current_round);
+    case PolicyMLFQ:
+        if (MlfqLevel(a) != MlfqLevel(b)) return MlfqLevel(a) < MlfqLevel(b);
+        break;
+    case PolicyCFS:
+        if (a.vruntime != b.vruntime) return a.vruntime < b.vruntime;
+        break;
+    default:
+        break;
+    }
+    return a.ready_seq < b.ready_seq;
+}
 
-            if (running_process->cpu_time == running_process->io_start && running_process->io_time > 0) {
-                running_process->state = Blocked;
-                blocked_queue.push_back(*running_process);
-                Log(L"进程" + running_process->name + L"（P" + to_wstring(running_process->ID) + L"）进入IO，阻塞" + to_wstring(running_process->io_time) + L"个时间片", current_time);
-                running_process.reset();
-                need_schedule = true;
-                continue;
-            }
+// 就绪堆的排序规则（HRRN和MLFQ不使用就绪堆，分别由选择树和多级队列保存就绪进程）
+bool ReadyOrder::operator()(PcbHandle a, PcbHandle b) const {
+    return owner->CompareReady(owner->Pcb(a), owner->Pcb(b));
+}
 
-            running_process->cpu_time++;
-            running_process->all_time--;
-
-            if (running_process->all_time == 0) {
-                running_process->end_time = current_time + 1;
-                running_process->state = Finish;
-                running_process->turnaround_time = running_process->end_time - running_process->arrive_time;
-                finish_queue.push_back(*running_process);
-                Log(L"进程" + running_process->name + L"（P" + to_wstring(running_process->ID) + L"）完成", current_time + 1);
-                running_process.reset();
-                need_schedule = true;
-            }
-        }
-        current_time++;
-    }
-    PrintAll(current_time);
+// 就绪堆中的位置字段
+int& ReadySlot::operator()(PcbHandle h) const {
+    return owner->Pcb(h).ready_pos;
 }
-// 高xj响应比优先（HRRN）
-void ProcessScheduler::HRRN() {
-    int current_time = 0;
-    bool need_schedule = true;
-    gantt_data.clear();
-    running_process.reset();
 
-    while (true) {
-        if (!running_process && arrive_queue.empty() && ready_queue.empty() && blocked_queue.empty()) break;
+// 选出第q个就绪队列中下一个要调度的进程
+PcbHandle ProcessScheduler::SelectNext(int q) {
+    if (QueueSize(q) == 0) return kNoProcess;
+    if (policy == PolicyHRRN) return hrrn_index[q].Top(current_round);
+    if (policy == PolicyMLFQ) return mlfq_index[q].Top();
+    return ready_queues[q].Top();
+}
+
+// 在CPU c上调度选中的进程
+void ProcessScheduler::DispatchNext(int c) {
+    CpuState& cpu = cpus[c];
+    int q = cpus[c].queue;
+    PcbHandle h = SelectNext(q);
+    QueueRemove(q, h);
+    ProcessPCB& pro = Pcb(h);
+    // 离开就绪队列时结算等待时间（HRRN的响应比由等待时间推算，不写入priority）
+    int ratio = policy == PolicyHRRN ? HrrnKey(pro, current_round) : 0;
+    pro.wait_time = ReadyWait(pro);
+    if (pro.start_time == -1)
+        pro.start_time = current_time;
+    if (pro.response_time == -1)
+        pro.response_time = current_time - pro.arrive_time;
+    pro.state = Executing;
+    pro.cpu = c;
+    cpu.running = h;
+    cpu.time_slice = 0;
+    if (policy == PolicyCFS) cpu.slice = CfsSlice(q, pro);
+
+    int key = policy == PolicySJF ? pro.service_time : policy == PolicyHRRN ? ratio :
+        policy == PolicyMLFQ ? MlfqLevel(pro) : policy == PolicyCFS ? cpu.slice : pro.priority;
+    Trace(EventDispatch, pro, current_time, c, key, pro.all_time);
+}
+
+// 完整处理一个调度轮次，返回true表示发生IO阻塞（同一时刻再调度一轮）
+bool ProcessScheduler::Step() {
+    MoveArrivedToReady(current_time);
+    UpdateBlockedQueue();
+    if (per_cpu_queues && balance_interval > 0 && current_time >= next_balance_time) {
+        Balance();
+        next_balance_time = (current_time / balance_interval + 1) * balance_interval;
+    }
+    if (policy == PolicyMLFQ && mlfq_boost > 0 && current_time >= next_boost_time) {
+        BoostMlfq();
+        next_boost_time = (current_time / mlfq_boost + 1) * mlfq_boost;
+    }
 
-        MoveArrivedToReady(current_time);
-        UpdateBlockedQueue();
+    // 本轮就绪的进程计入等待（离开就绪队列时再结算）
+    wait_counted_round = current_round + 1;
 
-        // 计算响应比并排序
-        if (!ready_queue.empty()) {
-            for (auto& pro : ready_queue) {
-                double response_ratio = (double)(pro.wait_time + pro.service_time) / pro.service_time;
-                pro.priority = static_cast<int>(response_ratio * 10000); // 用priority临时存储响应比，便于排序
+    // 各CPU依次调度；IO阻塞后的同一时刻只处理尚未执行这一时刻的CPU
+    bool io_blocked = false;
+    for (int c = 0; c < cpu_count; c++) {
+        if (cpus[c].next_time > current_time) continue;
+        if (RunCpu(c)) io_blocked = true;
+    }
+
+    // 执行过的进程在这一时刻结束后才回到就绪队列，不会在同一时刻被别的CPU再执行
+    if (!io_blocked) {
+        for (PcbHandle h : requeued) PushReady(h, current_round + 1);
+        requeued.clear();
+    }
+    return io_blocked;
+}
+
+// CPU c处理本轮：调度/抢占、IO阻塞或执行一个时间片，返回true表示运行进程进入IO
+bool ProcessScheduler::RunCpu(int c) {
+    CpuState& cpu = cpus[c];
+    ProcessQueue& queue = QueueOf(c);
+    if (work_stealing && per_cpu_queues && cpu.running == kNoProcess && QueueSize(cpu.queue) == 0) Steal(c);
+
+    if (policy == PolicySRTF) {
+        // 抢占判断
+        if (QueueSize(cpu.queue) > 0 && (cpu.running == kNoProcess || Pcb(queue.Top()).all_time < Pcb(cpu.running).all_time)) {
+            if (cpu.running != kNoProcess) PushReady(cpu.running, current_round + 1);
+            DispatchNext(c);
+        }
+    } else if (policy == PolicyMLFQ) {
+        // 更高级别的进程就绪时抢占，被抢占的进程保留级别回到队尾
+        if (QueueSize(cpu.queue) > 0 && (cpu.running == kNoProcess ||
+                mlfq_index[cpu.queue].TopLevel() < MlfqLevel(Pcb(cpu.running)))) {
+            if (cpu.running != kNoProcess) {
+                Trace(EventPreempted, Pcb(cpu.running), current_time, c);
+                PushReady(cpu.running, current_round + 1);
+            }
+            DispatchNext(c);
+        }
+    } else if (policy == PolicyCFS) {
+        // 队首的虚拟运行时间比运行进程少一个最小粒度以上时抢占（主要是IO完成的进程）
+        const long long granularity = (long long)cfs_min_granularity << kCfsShift;
+        if (QueueSize(cpu.queue) > 0 && (cpu.running == kNoProcess ||
+                Pcb(queue.Top()).vruntime + granularity < Pcb(cpu.running).vruntime)) {
+            if (cpu.running != kNoProcess) {
+                Trace(EventPreempted, Pcb(cpu.running), current_time, c);
+                PushReady(cpu.running, current_round + 1);
             }
-            std::sort(ready_queue.begin(), ready_queue.end(),
-                [](const ProcessPCB& a, const ProcessPCB& b) {
-                    return a.priority > b.priority;
-                });
+            DispatchNext(c);
         }
+    } else if (cpu.running == kNoProcess && QueueSize(cpu.queue) > 0) {
+        DispatchNext(c);
+    }
+
+    if (cpu.running == kNoProcess) return false;
+    ProcessPCB& pro = Pcb(cpu.running);
+
+    // IO阻塞
+    if (pro.cpu_time == pro.io_start && pro.io_time > 0) {
+        pro.state = Blocked;
+        blocked_queue.Insert(current_round + pro.io_time, cpu.running);
+        Trace(EventBlock, pro, current_time, c, pro.io_time);
+        if (policy == PolicyCFS) FairLeave(pro);
+        cpu.running = kNoProcess;
+        return true;
+    }
 
-        for (auto& pro : ready_queue) pro.wait_time++;
-
-        if (need_schedule && !ready_queue.empty()) {
-            running_process = std::unique_ptr<ProcessPCB>(new ProcessPCB(ready_queue[0]));
-            ready_queue.erase(ready_queue.begin());
-            if (running_process->start_time == -1)
-                running_process->start_time = current_time;
-            if (running_process->response_time == -1)
-                running_process->response_time = current_time - running_process->arrive_time;
-            running_process->state = Executing;
-            need_schedule = false;
-            Log(L"进程" + running_process->name + L"（P" + std::to_wstring(running_process->ID) + L"）开始执行", current_time);
-            PrintAll(current_time);
+    timelines[c].Append(pro.ID, current_time, 1);
+    pro.cpu_time++;
+    pro.all_time--;
+    cpu.time_slice++;
+    cpu.next_time = current_time + 1;
+    if (policy == PolicyCFS) pro.vruntime += CfsVruntimeStep(pro.priority);
+
+    if (pro.all_time == 0) {
+        pro.end_time = current_time + 1;
+        pro.state = Finish;
+        pro.turnaround_time = pro.end_time - pro.arrive_time;
+        finish_queue.push_back(cpu.running);
+        finish_stats.Record(pro);
+        Trace(EventFinish, pro, current_time + 1, c);
+        if (policy == PolicyCFS) fair_leaving.push_back(cpu.running);
+        cpu.running = kNoProcess;
+    } else if (policy == PolicyRoundRobin && cpu.time_slice == time_quantum) {
+        requeued.push_back(cpu.running);
+        Trace(EventQuantumExpired, pro, current_time + 1, c);
+        cpu.running = kNoProcess;
+    } else if (policy == PolicyCFS && cpu.time_slice == cpu.slice) {
+        requeued.push_back(cpu.running);
+        Trace(EventQuantumExpired, pro, current_time + 1, c);
+        cpu.running = kNoProcess;
+    } else if (policy == PolicyMLFQ && cpu.time_slice == mlfq_quanta[MlfqLevel(pro)]) {
+        // 用完本级时间片降一级
+        SetMlfqLevel(pro, min(MlfqLevel(pro) + 1, (int)mlfq_quanta.size() - 1));
+        requeued.push_back(cpu.running);
+        Trace(EventQuantumExpired, pro, current_time + 1, c);
+        cpu.running = kNoProcess;
+    } else if (policy == PolicyDynamicPriority) {
+        if (pro.priority > 1) pro.priority--;
+        if (QueueSize(cpu.queue) > 0 && Pcb(queue.Top()).priority >= pro.priority) {
+            requeued.push_back(cpu.running);
+            Trace(EventPreempted, pro, current_time + 1, c);
+            cpu.running = kNoProcess;
         }
+    }
+    return false;
+}
 
-        if (running_process) {
-            gantt_data.push_back(make_pair(running_process->ID, current_time));
+// CPU c的运行进程距下一次状态变化（IO、完成、时间片用尽、被抢占）还有几个平静轮次
+long long ProcessScheduler::RunningEventDelay(int c) const {
+    const CpuState& cpu = cpus[c];
+    const ProcessQueue& queue = QueueOf(c);
+    const ProcessPCB& pro = Pcb(cpu.running);
+    long long delay = pro.all_time - 1;
+    if (pro.io_time > 0 && pro.io_start >= pro.cpu_time)
+        delay = min<long long>(delay, pro.io_start - pro.cpu_time);
+    if (policy == PolicyRoundRobin)
+        delay = min<long long>(delay, time_quantum - cpu.time_slice - 1);
+    if (policy == PolicyMLFQ) {
+        int level = MlfqLevel(pro);
+        if (mlfq_index[cpu.queue].TopLevel() < level) return 0;
+        delay = min<long long>(delay, mlfq_quanta[level] - cpu.time_slice - 1);
+    }
+    if (policy == PolicyCFS) {
+        delay = min<long long>(delay, cpu.slice - cpu.time_slice - 1);
+        if (!queue.empty()) {
+            // 运行进程的虚拟运行时间每轮增加step，超过 队首+最小粒度 的那一轮抢占
+            long long gap = Pcb(queue.Top()).vruntime + ((long long)cfs_min_granularity << kCfsShift) - pro.vruntime;
+            if (gap < 0) return 0;
+            delay = min(delay, gap / CfsVruntimeStep(pro.priority) + 1);
+        }
+    }
+    if (policy == PolicyDynamicPriority && !queue.empty()) {
+        // 运行进程每执行一个时间片优先级减1（最低到1），就绪队首的优先级不变
+        int p = pro.priority, q = Pcb(queue.Top()).priority;
+        if (p <= 1) {
+            if (q >= p) delay = 0;
+        } else if (q >= 1) {
+            delay = min<long long>(delay, max(1, p - q) - 1);
+        }
+    }
+    return max(0LL, delay);
+}
 
-            if (running_process->cpu_time == running_process->io_start && running_process->io_time > 0) {
-                running_process->state = Blocked;
-                blocked_queue.push_back(*running_process);
-                Log(L"进程" + running_process->name + L"（P" + std::to_wstring(running_process->ID) + L"）进入IO", current_time);
-                running_process.reset();
-                need_schedule = true;
-                continue;
-            }
+// 空闲的CPU c本轮能否调度到进程
+bool ProcessScheduler::HasWorkFor(int c) const {
+    if (QueueSize(cpus[c].queue) > 0) return true;
+    if (!work_stealing || !per_cpu_queues) return false;
+    for (int q = 0; q < (int)ready_queues.size(); q++) {
+        if (QueueSize(q) > 0) return true;
+    }
+    return false;
+}
 
-            running_process->cpu_time++;
-            running_process->all_time--;
-
-            if (running_process->all_time == 0) {
-                running_process->end_time = current_time + 1;
-                running_process->state = Finish;
-                running_process->turnaround_time = running_process->end_time - running_process->arrive_time;
-                finish_queue.push_back(*running_process);
-                Log(L"进程" + running_process->name + L"（P" + std::to_wstring(running_process->ID) + L"）完成", current_time + 1);
-                running_process.reset();
-                need_schedule = true;
-            }
+// 下一个需要完整处理的轮次
+long long ProcessScheduler::NextEventRound() const {
+    long long next = LLONG_MAX;
+    for (int c = 0; c < cpu_count; c++) {
+        const CpuState& cpu = cpus[c];
+        if (cpu.next_time > current_time) return current_round;  // IO阻塞后这一时刻还没处理完
+        if (cpu.running == kNoProcess) {
+            if (HasWorkFor(c)) return current_round;
+        } else {
+            next = min(next, current_round + RunningEventDelay(c));
         }
-        current_time++;
     }
-    PrintAll(current_time);
+
+    if (arrive_pos < arrive_queue.size())
+        next = min(next, current_round + max(0, Pcb(arrive_queue[arrive_pos]).arrive_time - current_time));
+    if (!blocked_queue.empty())
+        next = min(next, max(blocked_queue.NextWake(), current_round));
+    if (per_cpu_queues && balance_interval > 0 && next != LLONG_MAX)
+        next = min(next, current_round + max(0, next_balance_time - current_time));
+    if (policy == PolicyMLFQ && mlfq_boost > 0 && next != LLONG_MAX)
+        next = min(next, current_round + max(0, next_boost_time - current_time));
+    return next == LLONG_MAX ? current_round : next;
 }
 
-// 最短剩余时间优先（SRTF）
-void ProcessScheduler::SRTF() {
-    int current_time = 0;
-    gantt_data.clear();
-    running_process.reset();
+// 批量推进若干个没有事件发生的轮次（CheckTimeRange保证推进后的时间仍在int范围内）
+void ProcessScheduler::Advance(long long rounds) {
+    int n = (int)rounds;
+    wait_counted_round += n;
+
+    for (int c = 0; c < cpu_count; c++) {
+        CpuState& cpu = cpus[c];
+        if (cpu.running == kNoProcess) continue;
+        ProcessPCB& pro = Pcb(cpu.running);
+        timelines[c].Append(pro.ID, current_time, n);
+        pro.cpu_time += n;
+        pro.all_time -= n;
+        cpu.time_slice += n;
+        cpu.next_time = current_time + n;
+        if (policy == PolicyDynamicPriority && pro.priority > 1)
+            pro.priority = max(1, pro.priority - n);
+        if (policy == PolicyCFS) pro.vruntime += n * CfsVruntimeStep(pro.priority);
+    }
+    if (policy == PolicyCFS) AdvanceFairClock(n);
+    current_time += n;
+    current_round += n;
+}
 
-    while (true) {
-        if (!running_process && arrive_queue.empty() && ready_queue.empty() && blocked_queue.empty()) break;
+// 设置CPU数和就绪队列的组织方式
+void ProcessScheduler::ConfigureCpus(int count, bool per_cpu, int balance, bool stealing) {
+    cpu_count = min(max(1, count), kMaxCpus);
+    per_cpu_queues = per_cpu && cpu_count > 1;
+    balance_interval = max(0, balance);
+    work_stealing = stealing;
+    ResetCpus();
+}
 
-        MoveArrivedToReady(current_time);
-        UpdateBlockedQueue();
+// 清空各CPU的运行状态、就绪队列和甘特图泳道
+void ProcessScheduler::ResetCpus() {
+    ready_queues.assign(per_cpu_queues ? cpu_count : 1, ProcessQueue(ReadyOrder{ this }, ReadySlot{ this }));
+    hrrn_index.assign(ready_queues.size(), HrrnIndex(HrrnRules{ this }));
+    mlfq_index.assign(ready_queues.size(), MlfqIndex(MlfqLinks{ this }, kNoProcess, (int)mlfq_quanta.size()));
+    cfs_load.assign(ready_queues.size(), 0);
+    cfs_min_vruntime.assign(ready_queues.size(), 0);
+    cpus.assign(cpu_count, CpuState{ kNoProcess, 0, 0, 0, 0 });
+    for (int c = 0; c < cpu_count; c++) cpus[c].queue = per_cpu_queues ? c : 0;
+    timelines.assign(cpu_count, Timeline());
+    requeued.clear();
+    next_balance_time = 0;
+    next_boost_time = 0;
+}
 
-        // 按剩余时间排序
-        if (!ready_queue.empty()) {
-            std::sort(ready_queue.begin(), ready_queue.end(),
-                [](const ProcessPCB& a, const ProcessPCB& b) {
-                    return a.all_time < b.all_time;
-                });
-        }
+// 模拟主循环：在事件之间直接跳转，结果与逐时钟推进一致
+void ProcessScheduler::Simulate(SchedulePolicy selected) {
+    Start(selected);
+    RunUntil(LLONG_MAX);
+}
 
-        for (auto& pro : ready_queue) pro.wait_time++;
+// 清空运行状态，准备用selected算法从0时刻开始模拟
+void ProcessScheduler::Start(SchedulePolicy selected) {
+    policy = selected;
+    current_time = 0;
+    current_round = 0;
+    wait_counted_round = 0;
+    mlfq_epoch = 0;
+    fair_clock = 0;
+    fair_weight = 0;
+    fair_count = 0;
+    fair_leaving.clear();
+    blocked_queue.Reset(0);
+    ResetCpus();
+    finish_stats.Clear();
+    step_count = 0;
+}
 
-        // 抢占判断
-        if (!ready_queue.empty()) {
-            if (!running_process || ready_queue[0].all_time < running_process->all_time) {
-                if (running_process) {
-                    running_process->state = Ready;
-                    ready_queue.push_back(*running_process);
-                }
-                running_process = std::unique_ptr<ProcessPCB>(new ProcessPCB(ready_queue[0]));
-                ready_queue.erase(ready_queue.begin());
-                if (running_process->start_time == -1)
-                    running_process->start_time = current_time;
-                if (running_process->response_time == -1)
-                    running_process->response_time = current_time - running_process->arrive_time;
-                running_process->state = Executing;
-                Log(L"进程" + running_process->name + L"（P" + std::to_wstring(running_process->ID) + L"）开始/被抢占执行", current_time);
-                PrintAll(current_time);
-            }
+// 是否还有未完成的进程（未到达、阻塞、运行中、就绪或本时刻执行后待回到就绪队列）
+bool ProcessScheduler::HasPending() const {
+    bool busy = arrive_pos < arrive_queue.size() || !blocked_queue.empty() || !requeued.empty();
+    for (int c = 0; c < cpu_count && !busy; c++)
+        busy = cpus[c].running != kNoProcess || QueueSize(cpus[c].queue) > 0;
+    return busy;
+}
+
+// 推进到time时刻或全部进程完成，返回是否已全部完成。
+// 停下时处于时刻边界：time之前的时刻都已处理完，time时刻还没有处理，批量推进在time处截断。
+// 截断后接着推进时从time时刻逐轮处理，平静的轮次单独处理与批量推进的结果相同
+bool ProcessScheduler::RunUntil(long long time) {
+    while (HasPending()) {
+        if (current_time >= time) return false;
+        bool io_blocked = Step();
+        step_count++;
+        current_round++;
+        if (!io_blocked) {
+            current_time++;
+            if (policy == PolicyCFS) AdvanceFairClock(1);
         }
 
-        if (running_process) {
-            gantt_data.push_back(make_pair(running_process->ID, current_time));
+        long long rounds = min(NextEventRound() - current_round, time - current_time);
+        if (rounds > 0) Advance(rounds);
+    }
+    return true;
+}
+
+// 复制source的全部模拟状态（PCB、各队列、CPU、时钟、统计和甘特图），各队列改为访问本调度器的PCB；
+// 不复制事件日志。source应停在RunUntil返回的时刻边界上，之后本调度器可接着推进
+void ProcessScheduler::CopyState(const ProcessScheduler& source) {
+    EventLog* log = event_log;
+    *this = source;
+    event_log = log;
+    RebindQueues();
+}
 
-            if (running_process->cpu_time == running_process->io_start && running_process->io_time > 0) {
-                running_process->state = Blocked;
-                blocked_queue.push_back(*running_process);
-                Log(L"进程" + running_process->name + L"（P" + std::to_wstring(running_process->ID) + L"）进入IO", current_time);
-                running_process.reset();
-                continue;
-            }
+// 与CopyState相同，但直接接过source的数组，不复制；之后source不应再使用
+void ProcessScheduler::TakeState(ProcessScheduler& source) {
+    EventLog* log = event_log;
+    *this = std::move(source);
+    event_log = log;
+    RebindQueues();
+}
 
-            running_process->cpu_time++;
-            running_process->all_time--;
+// 各就绪队列、HRRN选择树和MLFQ链表改为访问本调度器的PCB
+void ProcessScheduler::RebindQueues() {
+    for (ProcessQueue& queue : ready_queues) queue.Rebind(ReadyOrder{ this }, ReadySlot{ this });
+    for (HrrnIndex& index : hrrn_index) index.Rebind(HrrnRules{ this });
+    for (MlfqIndex& index : mlfq_index) index.Rebind(MlfqLinks{ this });
+}
 
-            if (running_process->all_time == 0) {
-                running_process->end_time = current_time + 1;
-                running_process->state = Finish;
-                running_process->turnaround_time = running_process->end_time - running_process->arrive_time;
-                finish_queue.push_back(*running_process);
-                Log(L"进程" + running_process->name + L"（P" + std::to_wstring(running_process->ID) + L"）完成", current_time + 1);
-                running_process.reset();
-            }
+// 在当前时刻改用selected算法和本调度器当前的参数继续模拟。
+// 算法不变（MLFQ级数也不变）时各队列原样保留，只把超出新时间片的运行进程截到本时刻后到期；
+// 算法改变时就绪进程按入队先后重新入队，运行进程的时间片重新计起，
+// 动态优先级改写的优先级恢复为输入值，MLFQ的进程都回到0级，CFS的虚拟运行时间和应得份额从0开始计算
+void ProcessScheduler::SwitchPolicy(SchedulePolicy selected) {
+    bool rebuild = selected != policy ||
+        (selected == PolicyMLFQ && mlfq_index[0].Levels() != (int)mlfq_quanta.size());
+    if (!rebuild) {
+        for (CpuState& cpu : cpus) {
+            if (cpu.running == kNoProcess) continue;
+            int limit = policy == PolicyRoundRobin ? time_quantum :
+                policy == PolicyMLFQ ? mlfq_quanta[MlfqLevel(Pcb(cpu.running))] : INT_MAX;
+            cpu.time_slice = min(cpu.time_slice, limit - 1);
         }
-        current_time++;
+        return;
+    }
+
+    // 取出各就绪队列中的进程，按入队先后排列
+    vector<pair<int, PcbHandle>> ready;
+    vector<PcbHandle> members;
+    for (int q = 0; q < (int)ready_queues.size(); q++) {
+        members.clear();
+        QueueMembers(q, members);
+        for (PcbHandle h : members) ready.push_back(make_pair(q, h));
+        ready_queues[q].Clear();
+        hrrn_index[q].Clear();
+    }
+    sort(ready.begin(), ready.end(), [this](const pair<int, PcbHandle>& a, const pair<int, PcbHandle>& b) {
+        return Pcb(a.second).ready_seq < Pcb(b.second).ready_seq;
+    });
+
+    SchedulePolicy previous = policy;
+    policy = selected;
+    for (ProcessPCB& pro : pcb_pool) {
+        if (pro.state == Finish) continue;
+        if (previous == PolicyDynamicPriority) pro.priority = pro.base_priority;
+        if (policy == PolicyCFS) {
+            pro.vruntime = 0;
+            pro.fair_share = 0;
+        }
+    }
+    mlfq_epoch++;
+    mlfq_index.assign(ready_queues.size(), MlfqIndex(MlfqLinks{ this }, kNoProcess, (int)mlfq_quanta.size()));
+    cfs_load.assign(ready_queues.size(), 0);
+    cfs_min_vruntime.assign(ready_queues.size(), 0);
+    fair_clock = 0;
+    fair_weight = 0;
+    fair_count = 0;
+    fair_leaving.clear();
+
+    for (const pair<int, PcbHandle>& entry : ready) {
+        QueuePush(entry.first, entry.second);
+        if (policy == PolicyCFS) FairEnter(Pcb(entry.second));
+    }
+    for (CpuState& cpu : cpus) {
+        cpu.time_slice = 0;
+        if (cpu.running == kNoProcess || policy != PolicyCFS) continue;
+        FairEnter(Pcb(cpu.running));
+        cpu.slice = CfsSlice(cpu.queue, Pcb(cpu.running));
     }
-    PrintAll(current_time);
 }
 
-// 输出统计信息
-void ProcessScheduler::PrintStatistics() {
-    if (finish_queue.empty()) return;
-    double avg_wait = 0, avg_turn = 0, avg_weighted = 0, avg_response = 0;
-    for (const auto& pro : finish_queue) {
-        avg_wait += pro.wait_time;
-        avg_turn += pro.turnaround_time;
-        avg_weighted += (double)pro.turnaround_time / pro.service_time;
-        avg_response += pro.response_time;
-    }
-    avg_wait /= finish_queue.size();
-    avg_turn /= finish_queue.size();
-    avg_weighted /= finish_queue.size();
-    avg_response /= finish_queue.size();
+// 先来先服务
+void ProcessScheduler::FCFS() {
+    Simulate(PolicyFCFS);
+}
 
-    wcout << L"\n统计信息：\n";
-    wcout << L"平均等待时间：" << avg_wait << L"\n";
-    wcout << L"平均周转时间：" << avg_turn << L"\n";
-    wcout << L"平均带权周转时间：" << avg_weighted << L"\n";
-    wcout << L"平均响应时间：" << avg_response << L"\n";
+// 时间片轮转
+void ProcessScheduler::RoundRobin() {
+    Simulate(PolicyRoundRobin);
+}
+
+// 动态优先级
+void ProcessScheduler::DynamicPriority() {
+    Simulate(PolicyDynamicPriority);
+}
+
+// 最短作业优先（SJF）
+void ProcessScheduler::SJF() {
+    Simulate(PolicySJF);
+}
+
+// 高响应比优先（HRRN）
+void ProcessScheduler::HRRN() {
+    Simulate(PolicyHRRN);
+}
+
+// 最短剩余时间优先（SRTF）
+void ProcessScheduler::SRTF() {
+    Simulate(PolicySRTF);
 }
 
-int main() {
-    // 设置控制台为UTF-8模式
-    SetConsoleOutputCP(CP_UTF8);
-    SetConsoleCP(CP_UTF8);
-    _setmode(_fileno(stdout), _O_U16TEXT);
+// 多级反馈队列（MLFQ）
+void ProcessScheduler::MLFQ() {
+    Simulate(PolicyMLFQ);
+}
 
-    wcout << L"===================================================\n";
-    wcout << L"          操作系统进程调度模拟实验        \n";
-    wcout << L"===================================================\n\n";
+// 完全公平调度（CFS）
+void ProcessScheduler::CFS() {
+    Simulate(PolicyCFS);
+}
 
-    ProcessScheduler scheduler;
-    scheduler.Run();
+// 完成进程的平均等待、周转、带权周转和响应时间（取自完成时记入的累计器，不再遍历完成队列）
+ScheduleStatistics ProcessScheduler::ComputeStatistics() const {
+    const FinishStatistics& all = finish_stats.all;
+    ScheduleStatistics stats = { (size_t)all.Count(), all.wait.Moments().Mean(), all.turnaround.Moments().Mean(),
+        all.weighted.Moments().Mean(), all.response.Moments().Mean() };
+    return stats;
+}
 
-    wcout << L"\n模拟结束，甘特图将在窗口中显示。\n";
-    return EXIT_SUCCESS;
+// 上下文切换次数：各CPU开始运行另一个进程（或空闲后开始运行）的次数，即甘特图中的非空闲段数
+long long ProcessScheduler::ContextSwitches() const {
+    long long switches = 0;
+    for (const Timeline& lane : timelines) {
+        for (const TimelineSegment& seg : lane.Segments()) {
+            if (seg.pid != kIdlePid) switches++;
+        }
+    }
+    return switches;
+}
+
+// 输出统计信息
+void ProcessScheduler::PrintStatistics() {
+    if (finish_stats.all.Count() == 0) return;
+    ScheduleStatistics stats = ComputeStatistics();
+
+    wcout << L"\n统计信息：\n";
+    wcout << L"平均等待时间：" << stats.avg_wait << L"\n";
+    wcout << L"平均周转时间：" << stats.avg_turnaround << L"\n";
+    wcout << L"平均带权周转时间：" << stats.avg_weighted << L"\n";
+    wcout << L"平均响应时间：" << stats.avg_response << L"\n";
+
+    if (timelines.size() > 1 && current_time > 0) {
+        for (size_t c = 0; c < timelines.size(); c++) {
+            long long busy = 0;
+            for (const TimelineSegment& seg : timelines[c].Segments()) {
+                if (seg.pid != kIdlePid) busy += seg.end - seg.start;
+            }
+            wcout << L"CPU" << c << L"利用率：" << 100.0 * busy / current_time << L"%\n";
+        }
+    }
+
+    // 分位数（直方图近似，相对误差不超过1%），有多个优先级时再按优先级分别输出
+    wcout << L"\n分位数（p50 / p90 / p99 / p99.9）：\n";
+    PrintQuantiles(finish_stats.all);
+    if (finish_stats.by_priority.size() > 1) {
+        for (const auto& entry : finish_stats.by_priority) {
+            wcout << L"优先级" << entry.first << L"（" << entry.second.Count() << L"个进程）：\n";
+            PrintQuantiles(entry.second);
+        }
+    }
+    if (policy == PolicyCFS) PrintFairness(pcb_pool, finish_queue);
 }
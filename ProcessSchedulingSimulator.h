@@ -6,6 +6,14 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <cstdint>
+#include "ReadyQueue.h"
+#include "KineticTournament.h"
+#include "MlfqQueue.h"
+#include "TimingWheel.h"
+#include "Timeline.h"
+#include "Statistics.h"
+#include "EventLog.h"
 
 #if __cplusplus < 201402L
 namespace std {
@@ -19,6 +27,18 @@ enum ProcessState {
     Executing, Ready, Finish, Unarrive, Blocked
 };
 
+// 调度算法编号（与SelectPolicy菜单一致）
+enum SchedulePolicy {
+    PolicyFCFS = 1, PolicyRoundRobin, PolicyDynamicPriority, PolicySJF, PolicyHRRN, PolicySRTF, PolicyMLFQ, PolicyCFS
+};
+const int kLastPolicy = PolicyCFS;
+
+// 一次IO：进程累计运行start个时间单位后阻塞time个时间单位
+struct IoBurst {
+    int32_t start;
+    int32_t time;
+};
+
 // 进程控制块(PCB)结构体
 struct ProcessPCB {
     int ID;
@@ -27,40 +47,228 @@ struct ProcessPCB {
     int io_start, io_time, all_time, cpu_time;
     int start_time, end_time, wait_time, response_time, turnaround_time, io_count;
     ProcessState state;
+    long long ready_round;    // 本次进入就绪队列后开始计入等待的轮次（wait_time只含此前各次的等待）
+    long long ready_seq;      // 进入就绪队列的序号，键值相同时先入队者优先
+    int ready_pos;            // 在所在就绪堆中的位置，不在就绪队列中时为-1
+    int cpu;                  // 最近一次运行所在的CPU，尚未运行时为-1
+    int hrrn_slot;            // 在HRRN选择树中的位置，不在树中时为-1
+    int base_priority;        // 输入的优先级（动态优先级会改写priority），按优先级分类统计时使用
+    uint32_t mlfq_prev, mlfq_next;  // MLFQ同级链表中的前后进程
+    int mlfq_level;           // MLFQ级别，mlfq_epoch不是当前提升周期时视为0级
+    long long mlfq_epoch;
+    long long vruntime;       // CFS虚拟运行时间（定点数，见Cfs.h）
+    double fair_start;        // CFS最近一次变为可运行时的公平时钟
+    double fair_share;        // CFS按权重应得的CPU时间（已离开可运行状态的各段之和）
+    uint32_t burst_offset;    // 第二次及以后的IO在burst_arena中的起点（io_start/io_time为第一次）
+    uint32_t burst_count;     // burst_arena中属于本进程的IO次数，为0时只有一次或没有IO
+    uint32_t burst_next;      // 下一次阻塞前要从burst_arena取出的序号
+};
+
+// PCB句柄：进程在PCB池中的下标，各队列只保存句柄
+typedef uint32_t PcbHandle;
+const PcbHandle kNoProcess = 0xFFFFFFFFu;
+
+const int kMaxCpus = 1024;
+
+class ProcessScheduler;
+
+// 就绪堆的排序规则，转发给所属调度器的当前算法
+struct ReadyOrder {
+    const ProcessScheduler* owner;
+    bool operator()(PcbHandle a, PcbHandle b) const;
+};
+
+// 就绪堆位置保存在PCB中，进程在各CPU的就绪队列间迁移时不需要额外的索引
+struct ReadySlot {
+    ProcessScheduler* owner;
+    int& operator()(PcbHandle h) const;
+};
+
+typedef ReadyQueue<PcbHandle, ReadyOrder, ReadySlot> ProcessQueue;
+
+// HRRN的选择规则：响应比 1 + 等待时间/服务时间 随轮次线性增长，按精确的有理数比较
+struct HrrnRules {
+    ProcessScheduler* owner;
+    bool Beats(PcbHandle a, PcbHandle b, long long round) const;
+    long long FailTime(PcbHandle winner, PcbHandle loser, long long round) const;
+    int& SlotOf(PcbHandle h) const;
+};
+
+typedef KineticTournament<PcbHandle, HrrnRules> HrrnIndex;
+
+// MLFQ各级链表的链接字段保存在PCB中
+struct MlfqLinks {
+    ProcessScheduler* owner;
+    PcbHandle& Prev(PcbHandle h) const;
+    PcbHandle& Next(PcbHandle h) const;
+};
+
+typedef MlfqQueue<PcbHandle, MlfqLinks> MlfqIndex;
+
+// 一次模拟的平均指标（PrintStatistics输出的各项）
+struct ScheduleStatistics {
+    size_t finished;
+    double avg_wait, avg_turnaround, avg_weighted, avg_response;
+};
+
+// 单个CPU的运行状态
+struct CpuState {
+    PcbHandle running;
+    int time_slice;
+    int queue;        // 使用的就绪队列下标（全局队列时都为0）
+    int next_time;    // 早于该时刻的时间片已执行过（IO阻塞后同一时刻再调度时跳过）
+    int slice;        // CFS本次调度分到的时间片
 };
 
 class ProcessScheduler {
 public:
     ProcessScheduler();
     ~ProcessScheduler();
+    // 各队列保存所属调度器的指针，复制或移交状态应使用CopyState/TakeState
+    ProcessScheduler(const ProcessScheduler&) = default;
+    ProcessScheduler& operator=(const ProcessScheduler&) = default;
+    ProcessScheduler& operator=(ProcessScheduler&&) = default;
 
-    void Run();
-    void ShowGanttChart();
+    bool Run(const std::string& workload_path = "", int selected = 0, const std::string& results_path = "");
+    bool ShowResults(const std::string& results_path);
     void InputProcesses();
+    bool LoadWorkload(const std::string& path);
+    bool SaveResults(const std::string& path);
+    bool LoadResults(const std::string& path);
+    void InitProcess(ProcessPCB& pro, int id);
+    void BuildArriveQueue(bool sorted);
+    void CopyWorkload(const ProcessScheduler& source);
+    bool CheckTimeRange(std::wstring& error) const;
     int SelectPolicy();
     void PrintAll(int current);
     void PrintProcess(const ProcessPCB* pro);
-    void Log(const std::wstring& msg, int current_time);
+    void PrintEvents(const EventLog& log) const;
     void MoveArrivedToReady(int current_time);
     void UpdateBlockedQueue();
     bool CompareArriveTime(const ProcessPCB& a, const ProcessPCB& b);
-    bool ComparePriority(const ProcessPCB& a, const ProcessPCB& b);
+    bool ComparePriority(const ProcessPCB& a, const ProcessPCB& b) const;
+
+    // 多CPU配置：per_cpu为真时每个CPU一个就绪队列，
+    // balance_interval>0时每隔该时长在队列间均衡一次，stealing为真时空闲CPU从最长的队列取进程
+    void ConfigureCpus(int count, bool per_cpu, int balance_interval, bool stealing);
+    void ResetCpus();
+
+    // 事件驱动的调度核心：只完整处理有事件发生的轮次，其余轮次批量推进
+    // Simulate相当于Start后RunUntil到全部完成；分段推进时可在两段之间取快照（见Snapshot.h）
+    void Simulate(SchedulePolicy policy);
+    void Start(SchedulePolicy policy);
+    bool RunUntil(long long time);
+    bool HasPending() const;
+    void CopyState(const ProcessScheduler& source);
+    void TakeState(ProcessScheduler& source);
+    void RebindQueues();
+    void SwitchPolicy(SchedulePolicy selected);
+    bool Step();
+    bool RunCpu(int c);
+    void Advance(long long rounds);
+    long long NextEventRound() const;
+    long long RunningEventDelay(int c) const;
+    bool HasWorkFor(int c) const;
+    void PushReady(PcbHandle h, long long counted_from);
+    int PickQueue(const ProcessPCB& pro) const;
+    void Balance();
+    bool Steal(int c);
+    void DispatchNext(int c);
+    PcbHandle SelectNext(int q);
+    void QueuePush(int q, PcbHandle h);
+    void QueueRemove(int q, PcbHandle h);
+    size_t QueueSize(int q) const;
+    void QueueMembers(int q, std::vector<PcbHandle>& out) const;
+    ProcessQueue& QueueOf(int c) { return ready_queues[cpus[c].queue]; }
+    const ProcessQueue& QueueOf(int c) const { return ready_queues[cpus[c].queue]; }
+    bool CompareReady(const ProcessPCB& a, const ProcessPCB& b) const;
+    int HrrnKey(const ProcessPCB& pro, long long round) const;
+    bool HrrnBefore(const ProcessPCB& a, const ProcessPCB& b, long long round) const;
+    long long HrrnOvertake(const ProcessPCB& winner, const ProcessPCB& loser, long long round) const;
+    int MlfqLevel(const ProcessPCB& pro) const { return pro.mlfq_epoch == mlfq_epoch ? pro.mlfq_level : 0; }
+    void SetMlfqLevel(ProcessPCB& pro, int level);
+    void BoostMlfq();
+    long long CfsMinVruntime(int q);
+    void PlaceCfs(ProcessPCB& pro, int q);
+    int CfsSlice(int q, const ProcessPCB& pro) const;
+    void FairEnter(ProcessPCB& pro);
+    void FairLeave(ProcessPCB& pro);
+    void AdvanceFairClock(int n);
+    int ReadyWait(const ProcessPCB& pro) const;
+    std::wstring DisplayName(const ProcessPCB& pro) const;
 
     void FCFS();
     void RoundRobin();
     void DynamicPriority();
     void SJF();
+    ScheduleStatistics ComputeStatistics() const;
+    long long ContextSwitches() const;
     void PrintStatistics();
     void HRRN();
     void SRTF();
+    void MLFQ();
+    void CFS();
+
+    // 记录调度事件；未启用事件日志时只有一次空指针判断
+    void Trace(EventType type, const ProcessPCB& pro, int time, int cpu, int arg0 = 0, int arg1 = 0) {
+        if (event_log) event_log->Record(type, time, pro.ID, cpu, arg0, arg1);
+    }
+
+    ProcessPCB& Pcb(PcbHandle h) { return pcb_pool[h]; }
+    const ProcessPCB& Pcb(PcbHandle h) const { return pcb_pool[h]; }
+
+    // 全部PCB存放在池中，模拟期间位置不变；状态切换只在队列间移动句柄
+    std::vector<ProcessPCB> pcb_pool;
 
     // 队列
-    std::vector<ProcessPCB> arrive_queue;
-    std::vector<ProcessPCB> ready_queue;
-    std::vector<ProcessPCB> blocked_queue;
-    std::vector<ProcessPCB> finish_queue;
-    std::vector<std::pair<int, int>> gantt_data;
-    std::unique_ptr<ProcessPCB> running_process;
+    std::vector<IoBurst> burst_arena;       // 各进程第二次及以后的IO，按进程连续存放，按开始位置排列
+    std::vector<PcbHandle> arrive_queue;    // 按到达时间排序，arrive_pos之前的已到达
+    size_t arrive_pos;
+    std::vector<ProcessQueue> ready_queues; // 全局队列模式下只有一个
+    std::vector<HrrnIndex> hrrn_index;      // HRRN时与ready_queues一一对应，用于选出响应比最高的进程
+    std::vector<MlfqIndex> mlfq_index;      // MLFQ时与ready_queues一一对应，按级别和先后选出进程
+    std::vector<long long> cfs_load;        // CFS时各就绪队列中进程的权重之和
+    std::vector<long long> cfs_min_vruntime;// CFS时各就绪队列的最小虚拟运行时间（单调不减）
+    TimingWheel<PcbHandle> blocked_queue;   // 按IO完成轮次登记的阻塞进程
+    std::vector<PcbHandle> finish_queue;
+    ScheduleAccumulator finish_stats;       // 进程完成时记入的流式统计（均值、方差和分位数）
+    std::vector<Timeline> timelines;        // 每个CPU一条甘特图泳道（游程编码）
+    std::vector<CpuState> cpus;
+    std::vector<PcbHandle> requeued;        // 本时刻执行后回到就绪队列的进程，时刻结束时再入队
+
+    // 多CPU配置
+    int cpu_count;
+    bool per_cpu_queues;
+    int balance_interval;
+    bool work_stealing;
+    int next_balance_time;
+
+    // 模拟时钟：阻塞后同一时刻会再调度一轮，因此轮次与时间分开记录
+    SchedulePolicy policy;
+    int current_time;              // 模拟前由CheckTimeRange保证不会溢出
+    long long current_round;
+    long long wait_counted_round;  // 就绪进程的等待时间已累计到该轮之前
+    long long ready_counter;
+    int time_quantum;              // 时间片轮转的时间片长度，运行时可设置
+    std::vector<int> mlfq_quanta;  // MLFQ各级的时间片长度（0级最高），级数不超过64
+    int mlfq_boost;                // MLFQ每隔该时长把所有进程提升到0级，0表示不提升
+    int next_boost_time;
+    long long mlfq_epoch;          // 提升的次数，PCB中记录的级别属于更早的周期时作废
+    int cfs_latency;               // CFS目标延迟：可运行进程不多时，每个进程在该时长内至少运行一次
+    int cfs_min_granularity;       // CFS最小粒度：时间片的下限，也是唤醒进程抢占所需的虚拟运行时间差
+    double fair_clock;             // CFS公平时钟：权重为1的进程到目前为止应得的CPU时间
+    long long fair_weight;         // 可运行（就绪或运行中）进程的权重之和
+    int fair_count;                // 可运行进程数
+    std::vector<PcbHandle> fair_leaving; // 本时刻完成的进程，这一时刻结束后才离开可运行状态
+    std::vector<PcbHandle> woken;  // 本轮IO完成的进程（复用缓冲区）
+
+    bool quiet;             // 不输出调度日志和进程表（用于性能测试）
+    EventLog* event_log;    // 非空时模拟过程中的调度事件写入该日志（不负责释放）
+    EventLevel trace_level; // Run记录调度事件的详细程度
+    std::string trace_path; // 非空时Run把调度事件写入该文件，不再输出调度日志
+    std::string cache_path; // 非空时Run先在该目录的结果缓存中查找，未命中时模拟后存入（见ResultCache.h）
+    uint64_t cache_limit;   // 结果缓存目录的容量（字节）
+    long long step_count;   // 本次模拟完整处理的轮次数
 };
 
 #endif
@@ -0,0 +1,128 @@
+#include "stdafx.h"
+#include "QuantumTuner.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <iterator>
+#include <thread>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+QuantumTuner::QuantumTuner(const ProcessScheduler& workload) : m_workload(workload) {}
+
+// 粗扫后按两项时间指标分别细化
+void QuantumTuner::Tune(int max_quantum, int threads) {
+    if (max_quantum <= 0) {
+        max_quantum = 1;
+        for (const ProcessPCB& pro : m_workload.pcb_pool) max_quantum = max(max_quantum, pro.service_time);
+    }
+    vector<int> coarse;
+    for (int q = 1; q < max_quantum && q <= INT_MAX / 2; q *= 2) coarse.push_back(q);
+    coarse.push_back(max_quantum);
+    Evaluate(coarse, threads);
+
+    double QuantumResult::*objectives[] = { &QuantumResult::avg_response, &QuantumResult::avg_turnaround };
+    for (double QuantumResult::*objective : objectives) {
+        map<int, QuantumResult>::const_iterator best = m_results.find(Best(objective));
+        int lo = best == m_results.begin() ? best->first : prev(best)->first;
+        int hi = next(best) == m_results.end() ? best->first : next(best)->first;
+        Refine(objective, lo, hi, threads);
+    }
+}
+
+// 并行模拟尚未模拟过的时间片
+void QuantumTuner::Evaluate(const vector<int>& quanta, int threads) {
+    vector<int> todo;
+    for (int q : quanta) {
+        if (q >= 1 && !m_results.count(q) && find(todo.begin(), todo.end(), q) == todo.end()) todo.push_back(q);
+    }
+    vector<QuantumResult> results(todo.size());
+    ParallelFor(todo.size(), threads, [&](size_t i) {
+        ProcessScheduler scheduler;
+        scheduler.quiet = true;
+        scheduler.CopyWorkload(m_workload);
+        scheduler.time_quantum = todo[i];
+        scheduler.Simulate(PolicyRoundRobin);
+        ScheduleStatistics stats = scheduler.ComputeStatistics();
+        QuantumResult& result = results[i];
+        result.quantum = todo[i];
+        result.avg_response = stats.avg_response;
+        result.avg_turnaround = stats.avg_turnaround;
+        result.context_switches = scheduler.ContextSwitches();
+    });
+    for (const QuantumResult& result : results) m_results[result.quantum] = result;
+}
+
+// 在[lo, hi]内缩小区间：每轮并行模拟若干等距的候选，保留最优点两侧相邻的已模拟点
+void QuantumTuner::Refine(double QuantumResult::*objective, int lo, int hi, int threads) {
+    int candidates = max(3, threads > 0 ? threads : (int)thread::hardware_concurrency());
+    while (hi - lo > 1) {
+        vector<int> quanta;
+        double step = (double)(hi - lo) / (candidates + 1);
+        for (int i = 1; i <= candidates; i++) {
+            int q = lo + (int)llround(step * i);
+            if (q > lo && q < hi && !m_results.count(q)) quanta.push_back(q);
+        }
+        if (quanta.empty()) break;
+        Evaluate(quanta, threads);
+
+        map<int, QuantumResult>::const_iterator first = m_results.find(lo), last = m_results.find(hi);
+        map<int, QuantumResult>::const_iterator best = first;
+        for (map<int, QuantumResult>::const_iterator it = first; it != next(last); ++it) {
+            if (it->second.*objective < best->second.*objective) best = it;
+        }
+        int new_lo = best == first ? lo : prev(best)->first;
+        int new_hi = best == last ? hi : next(best)->first;
+        lo = new_lo;
+        hi = new_hi;
+    }
+}
+
+// 指标最小的时间片，相同时取较小的时间片
+int QuantumTuner::Best(double QuantumResult::*objective) const {
+    map<int, QuantumResult>::const_iterator best = m_results.begin();
+    for (map<int, QuantumResult>::const_iterator it = m_results.begin(); it != m_results.end(); ++it) {
+        if (it->second.*objective < best->second.*objective) best = it;
+    }
+    return best->first;
+}
+
+vector<QuantumResult> QuantumTuner::Results() const {
+    vector<QuantumResult> results;
+    for (const auto& entry : m_results) results.push_back(entry.second);
+    return results;
+}
+
+vector<QuantumResult> QuantumTuner::Frontier() const {
+    vector<QuantumResult> all = Results(), frontier;
+    for (const QuantumResult& a : all) {
+        bool dominated = false;
+        for (const QuantumResult& b : all) {
+            if (b.avg_response <= a.avg_response && b.avg_turnaround <= a.avg_turnaround &&
+                b.context_switches <= a.context_switches &&
+                (b.avg_response < a.avg_response || b.avg_turnaround < a.avg_turnaround ||
+                 b.context_switches < a.context_switches)) {
+                dominated = true;
+                break;
+            }
+        }
+        if (!dominated) frontier.push_back(a);
+    }
+    return frontier;
+}
+
+// 输出帕累托前沿
+void QuantumTuner::PrintFrontier(const vector<QuantumResult>& frontier) {
+    wcout << L"\n时间片的帕累托前沿（平均响应时间、平均周转时间、上下文切换次数）：\n";
+    wcout << L"    时间片|  平均响应|  平均周转|  上下文切换\n";
+    for (const QuantumResult& result : frontier) {
+        wcout << setw(10) << result.quantum
+            << fixed << setprecision(2)
+            << setw(10) << result.avg_response
+            << setw(10) << result.avg_turnaround
+            << setw(14) << result.context_switches << L"\n";
+    }
+}
@@ -0,0 +1,43 @@
+// QuantumTuner.h
+#pragma once
+
+#include <map>
+#include <vector>
+#include "ProcessSchedulingSimulator.h"
+
+// 一个时间片长度下时间片轮转的模拟结果
+struct QuantumResult {
+    int quantum;
+    double avg_response;
+    double avg_turnaround;
+    long long context_switches;
+};
+
+// 时间片轮转的时间片长度搜索
+// 先在1到上限之间按2的幂粗扫，再分别在平均响应时间和平均周转时间最小的点附近细化：
+// 每轮在当前区间内并行模拟若干等距的候选值，把区间缩小到最优候选的两侧，直到区间内的整数都已模拟。
+// 所有模拟过的时间片按（平均响应时间，平均周转时间，上下文切换次数）求帕累托前沿。
+// 负载保存在不做模拟的调度器中，各候选用独立的调度器复制后模拟。
+class QuantumTuner {
+public:
+    explicit QuantumTuner(const ProcessScheduler& workload);
+
+    // max_quantum为0时取最长的服务时间（时间片再长结果与先来先服务相同）；threads为0时按硬件线程数
+    void Tune(int max_quantum, int threads);
+
+    // 全部模拟过的结果，按时间片升序
+    std::vector<QuantumResult> Results() const;
+
+    // 帕累托前沿：没有其他结果在三项指标上都不差且至少一项更好，按时间片升序
+    std::vector<QuantumResult> Frontier() const;
+
+    static void PrintFrontier(const std::vector<QuantumResult>& frontier);
+
+private:
+    void Evaluate(const std::vector<int>& quanta, int threads);
+    void Refine(double QuantumResult::*objective, int lo, int hi, int threads);
+    int Best(double QuantumResult::*objective) const;
+
+    const ProcessScheduler& m_workload;
+    std::map<int, QuantumResult> m_results;
+};
@@ -0,0 +1,119 @@
+// ReadyQueue.h
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+// 就绪队列：带位置索引的4叉堆
+// Before(a, b) 为真表示a应先于b被调度；PosOf(a)返回元素自带的堆位置字段（int&），
+// 不在任何队列中时为-1。位置保存在元素自身，多个队列不必各自维护按ID的索引，
+// 但同一元素同一时刻只能在一个队列中。
+// 支持 O(log n) 的入队和删除任意元素，O(1) 取队首。元素在队列中时排序键不得改变
+template <typename T, typename Before, typename PosOf>
+class ReadyQueue {
+public:
+    typedef typename std::vector<T>::iterator iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+    explicit ReadyQueue(Before before = Before(), PosOf pos_of = PosOf())
+        : m_before(before), m_pos_of(pos_of) {}
+
+    bool empty() const { return m_items.empty(); }
+    size_t size() const { return m_items.size(); }
+
+    // 元素按堆顺序存放
+    iterator begin() { return m_items.begin(); }
+    iterator end() { return m_items.end(); }
+    const_iterator begin() const { return m_items.begin(); }
+    const_iterator end() const { return m_items.end(); }
+
+    const T& Top() const { return m_items[0]; }
+
+    void Push(const T& item) {
+        m_items.push_back(item);
+        m_pos_of(m_items.back()) = (int)m_items.size() - 1;
+        SiftUp(m_items.size() - 1);
+    }
+
+    bool Contains(const T& item) const {
+        int pos = m_pos_of(item);
+        return pos >= 0 && (size_t)pos < m_items.size() && m_items[pos] == item;
+    }
+
+    // 删除元素，不在本队列中时返回false
+    bool Remove(const T& item) {
+        if (!Contains(item)) return false;
+        size_t i = m_pos_of(item);
+        m_pos_of(m_items[i]) = -1;
+        RemoveAt(i);
+        return true;
+    }
+
+    void Clear() {
+        for (const T& item : m_items) m_pos_of(item) = -1;
+        m_items.clear();
+    }
+
+    // 换用新的比较和位置函数（队列连同元素一起复制到别处后使用），新旧函数给出的顺序必须相同
+    void Rebind(Before before, PosOf pos_of) {
+        m_before = before;
+        m_pos_of = pos_of;
+    }
+
+private:
+    static const size_t kArity = 4;
+
+    // 删除位置i的元素（调用前已清除其索引）
+    void RemoveAt(size_t i) {
+        size_t last = m_items.size() - 1;
+        if (i != last) {
+            m_items[i] = std::move(m_items[last]);
+            m_pos_of(m_items[i]) = (int)i;
+        }
+        m_items.pop_back();
+        if (i < m_items.size()) {
+            T moved = m_items[i];
+            SiftUp(i);
+            SiftDown(m_pos_of(moved));
+        }
+    }
+
+    void SiftUp(size_t i) {
+        T item = std::move(m_items[i]);
+        while (i > 0) {
+            size_t parent = (i - 1) / kArity;
+            if (!m_before(item, m_items[parent])) break;
+            Place(i, std::move(m_items[parent]));
+            i = parent;
+        }
+        Place(i, std::move(item));
+    }
+
+    void SiftDown(size_t i) {
+        size_t n = m_items.size();
+        T item = std::move(m_items[i]);
+        while (true) {
+            size_t first = i * kArity + 1;
+            if (first >= n) break;
+            size_t best = first;
+            size_t stop = first + kArity < n ? first + kArity : n;
+            for (size_t c = first + 1; c < stop; c++) {
+                if (m_before(m_items[c], m_items[best])) best = c;
+            }
+            if (!m_before(m_items[best], item)) break;
+            Place(i, std::move(m_items[best]));
+            i = best;
+        }
+        Place(i, std::move(item));
+    }
+
+    void Place(size_t i, T&& item) {
+        m_items[i] = std::move(item);
+        m_pos_of(m_items[i]) = (int)i;
+    }
+
+    std::vector<T> m_items;
+    Before m_before;
+    PosOf m_pos_of;
+};
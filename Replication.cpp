@@ -0,0 +1,117 @@
+#include "stdafx.h"
+#include "Replication.h"
+#include "PolicyComparison.h"
+#include "ParallelFor.h"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+namespace {
+
+// 每个任务连续处理的重复数；分块方式固定，汇总结果与线程数无关
+const size_t kBlockSize = 16;
+
+void PrintMetric(const wchar_t* title, const RunningStat& stat) {
+    double half = stat.HalfWidth95();
+    wcout << title << stat.Mean() << L"，标准差" << stat.Stddev()
+        << L"，95%置信区间[" << stat.Mean() - half << L", " << stat.Mean() + half << L"]\n";
+}
+
+} // namespace
+
+ReplicationRunner::ReplicationRunner(const GeneratorConfig& config, const ProcessScheduler& settings)
+    : m_config(config), m_settings(settings) {
+    m_config.threads = 1;  // 并行在重复之间进行，单次生成不再开线程
+}
+
+uint64_t ReplicationRunner::ReplicationSeed(uint64_t base, size_t r) {
+    return base + (uint64_t)r * 0x9E3779B97F4A7C15ULL;
+}
+
+size_t ReplicationRunner::Run(size_t replications, const vector<int>& policies, int threads,
+    vector<ReplicationSummary>& out) const {
+    // 第r次重复第i个算法的结果存于runs[r * policies.size() + i]
+    vector<ScheduleStatistics> runs(replications * policies.size());
+    vector<char> skipped(replications, 0);
+    // 每块各算法所有完成进程的合并统计，用于分位数
+    size_t blocks = (replications + kBlockSize - 1) / kBlockSize;
+    vector<vector<FinishStatistics>> pooled(blocks, vector<FinishStatistics>(policies.size()));
+
+    ParallelFor(blocks, threads, [&](size_t b) {
+        for (size_t r = b * kBlockSize; r < replications && r < (b + 1) * kBlockSize; r++)
+            RunReplication(r, policies, runs, skipped, pooled[b]);
+    });
+
+    out.assign(policies.size(), ReplicationSummary());
+    for (size_t i = 0; i < policies.size(); i++) {
+        out[i].policy = policies[i];
+        for (size_t b = 0; b < blocks; b++) out[i].pooled.Merge(pooled[b][i]);
+    }
+    size_t skipped_count = 0;
+    for (size_t r = 0; r < replications; r++) {
+        if (skipped[r]) {
+            skipped_count++;
+            continue;
+        }
+        for (size_t i = 0; i < policies.size(); i++) {
+            const ScheduleStatistics& stats = runs[r * policies.size() + i];
+            if (stats.finished == 0) continue;
+            out[i].wait.Add(stats.avg_wait);
+            out[i].turnaround.Add(stats.avg_turnaround);
+            out[i].weighted.Add(stats.avg_weighted);
+            out[i].response.Add(stats.avg_response);
+        }
+    }
+    return skipped_count;
+}
+
+// 第r次重复：生成负载后依次模拟各算法，只写入第r次重复自己的结果和本块的合并统计
+void ReplicationRunner::RunReplication(size_t r, const vector<int>& policies, vector<ScheduleStatistics>& runs,
+    vector<char>& skipped, vector<FinishStatistics>& pooled) const {
+    GeneratorConfig config = m_config;
+    config.seed = ReplicationSeed(m_config.seed, r);
+    ProcessScheduler source;
+    source.ConfigureCpus(m_settings.cpu_count, m_settings.per_cpu_queues,
+        m_settings.balance_interval, m_settings.work_stealing);
+    source.time_quantum = m_settings.time_quantum;
+    source.mlfq_quanta = m_settings.mlfq_quanta;
+    source.mlfq_boost = m_settings.mlfq_boost;
+    source.cfs_latency = m_settings.cfs_latency;
+    source.cfs_min_granularity = m_settings.cfs_min_granularity;
+    wstring error;
+    if (!WorkloadGenerator(config).Generate(source.pcb_pool, source.burst_arena, error)) {
+        skipped[r] = 1;
+        return;
+    }
+    for (size_t i = 0; i < source.pcb_pool.size(); i++) source.InitProcess(source.pcb_pool[i], (int)i + 1);
+    source.BuildArriveQueue(true);
+    if (!source.CheckTimeRange(error)) {
+        skipped[r] = 1;
+        return;
+    }
+
+    ProcessScheduler scheduler;
+    scheduler.quiet = true;
+    for (size_t i = 0; i < policies.size(); i++) {
+        scheduler.CopyWorkload(source);
+        scheduler.Simulate((SchedulePolicy)policies[i]);
+        runs[r * policies.size() + i] = scheduler.ComputeStatistics();
+        pooled[i].Merge(scheduler.finish_stats.all);
+    }
+}
+
+// 输出各算法的均值、标准差、95%置信区间和合并后的分位数
+void ReplicationRunner::PrintSummary(const vector<ReplicationSummary>& summaries) {
+    for (const ReplicationSummary& summary : summaries) {
+        wcout << L"\n" << PolicyTitle(summary.policy) << L"（" << summary.wait.Count() << L"次重复）：\n"
+            << fixed << setprecision(3);
+        PrintMetric(L"平均等待时间：", summary.wait);
+        PrintMetric(L"平均周转时间：", summary.turnaround);
+        PrintMetric(L"平均带权周转时间：", summary.weighted);
+        PrintMetric(L"平均响应时间：", summary.response);
+        wcout << L"全部进程的分位数（p50 / p90 / p99 / p99.9）：\n";
+        PrintQuantiles(summary.pooled);
+    }
+}
@@ -0,0 +1,42 @@
+// Replication.h
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "ProcessSchedulingSimulator.h"
+#include "WorkloadGenerator.h"
+#include "Statistics.h"
+
+// 一个算法在全部重复中的汇总，各项是每次模拟的平均值再跨重复统计
+struct ReplicationSummary {
+    int policy;
+    RunningStat wait, turnaround, weighted, response;
+    FinishStatistics pooled;  // 全部重复中所有完成进程合并后的统计，用于分位数
+};
+
+// Monte Carlo重复实验
+// 第r次重复用由基准种子和r导出的种子生成负载，同一次重复中各算法使用同一份负载（公共随机数），
+// 算法间的差异因此不受负载抽样的影响。每16次重复是线程池中的一个任务，
+// 任务内创建自己的调度器，结果写入各自的下标，全部完成后再按重复编号和块号顺序合并，
+// 因此结果与线程数无关。
+class ReplicationRunner {
+public:
+    // settings提供CPU配置和时间片长度，只读
+    ReplicationRunner(const GeneratorConfig& config, const ProcessScheduler& settings);
+
+    // 运行replications次重复，threads为0时按硬件线程数；返回负载时长超出范围而跳过的重复数
+    size_t Run(size_t replications, const std::vector<int>& policies, int threads,
+        std::vector<ReplicationSummary>& out) const;
+
+    // 第r次重复使用的种子
+    static uint64_t ReplicationSeed(uint64_t base, size_t r);
+
+    static void PrintSummary(const std::vector<ReplicationSummary>& summaries);
+
+private:
+    void RunReplication(size_t r, const std::vector<int>& policies, std::vector<ScheduleStatistics>& runs,
+        std::vector<char>& skipped, std::vector<FinishStatistics>& pooled) const;
+
+    GeneratorConfig m_config;
+    const ProcessScheduler& m_settings;
+};
@@ -0,0 +1,388 @@
+#include "stdafx.h"
+#include "ResultCache.h"
+#include "MappedFile.h"
+#include "Utf8.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+const uint32_t kCacheMagic = 0x43535350;  // "PSSC"
+const uint16_t kCacheVersion = 1;         // 同时计入键，格式或引擎语义改变时递增，旧条目自然失效
+const char kCacheExtension[] = ".result";
+
+// 条目文件头，之后依次是记录、进程名（UTF-8）和压缩的甘特图段
+struct CacheHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t policy;
+    uint64_t key_hi, key_lo;
+    uint32_t lanes;         // CPU泳道数
+    int32_t end_time;       // 模拟结束时刻
+    uint64_t records;       // 完成进程数
+    uint64_t names;         // 进程名的总字节数
+    uint64_t segments;      // 压缩后甘特图段的字节数
+    uint64_t checksum;      // 文件头之后全部内容的哈希
+};
+
+// 一个完成进程，按完成顺序存放
+struct CacheRecord {
+    int32_t id;
+    int32_t arrive_time, service_time, priority, base_priority;
+    int32_t io_start, io_time, cpu;
+    int32_t start_time, end_time, wait_time, response_time, turnaround_time, io_count;
+    uint32_t name_length;   // 进程名依次存放，按长度切分
+    int32_t reserved;
+    double fair_share;      // CFS公平性报告用
+};
+
+static_assert(sizeof(CacheHeader) == 64, "CacheHeader layout");
+static_assert(sizeof(CacheRecord) == 72, "CacheRecord layout");
+
+uint64_t Mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t Pack(int32_t a, int32_t b) {
+    return (uint64_t)(uint32_t)a << 32 | (uint32_t)b;
+}
+
+// 128位内容哈希：两路状态以不同方式混入每个64位字，结束时再互相混合。
+// 不是密码学哈希，只用于区分不同的负载和校验条目内容
+class ContentHash {
+public:
+    ContentHash() : m_a(0x243F6A8885A308D3ULL), m_b(0x13198A2E03707344ULL), m_words(0) {}
+
+    void Add(uint64_t word) {
+        m_a = Mix(m_a ^ word);
+        m_b = Mix(m_b + word * 0x9E3779B97F4A7C15ULL);
+        m_words++;
+    }
+
+    // 按小端8字节一组混入，末组补0，长度另计入
+    void AddBytes(const char* data, size_t size) {
+        Add(size);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) Add(LoadWord(data + i, 8));
+        if (i < size) Add(LoadWord(data + i, size - i));
+    }
+
+    ResultKey Finish() const {
+        uint64_t lo = Mix(m_a ^ m_words);
+        return ResultKey{ Mix(m_b ^ lo), lo };
+    }
+
+private:
+    static uint64_t LoadWord(const char* p, size_t n) {
+        uint64_t word = 0;
+        for (size_t k = 0; k < n; k++) word |= (uint64_t)(unsigned char)p[k] << (8 * k);
+        return word;
+    }
+
+    uint64_t m_a, m_b, m_words;
+};
+
+uint64_t Checksum(const char* data, size_t size) {
+    ContentHash hash;
+    hash.AddBytes(data, size);
+    return hash.Finish().lo;
+}
+
+// LEB128变长整数
+void PutVarint(string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((char)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+bool GetVarint(const char*& p, const char* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        unsigned char byte = (unsigned char)*p++;
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+uint64_t ZigZag(long long n) { return ((uint64_t)n << 1) ^ (uint64_t)(n >> 63); }
+long long UnZigZag(uint64_t n) { return (long long)(n >> 1) ^ -(long long)(n & 1); }
+
+// 甘特图段按泳道编码：段数，之后每段为与上一段的进程ID之差、与上一段结束之间的空闲时长和运行时长，
+// 空闲段不保存（Timeline::Append会补上），每段通常只占3到5个字节
+void EncodeSegments(const vector<Timeline>& lanes, string& out) {
+    for (const Timeline& lane : lanes) {
+        size_t count = 0;
+        for (const TimelineSegment& seg : lane.Segments()) count += seg.pid != kIdlePid;
+        PutVarint(out, count);
+        long long pid = 0, end = 0;
+        for (const TimelineSegment& seg : lane.Segments()) {
+            if (seg.pid == kIdlePid) continue;
+            PutVarint(out, ZigZag(seg.pid - pid));
+            PutVarint(out, (uint64_t)(seg.start - end));
+            PutVarint(out, (uint64_t)(seg.end - seg.start));
+            pid = seg.pid;
+            end = seg.end;
+        }
+    }
+}
+
+bool DecodeSegments(const char* p, const char* end, vector<Timeline>& lanes) {
+    for (Timeline& lane : lanes) {
+        uint64_t count;
+        if (!GetVarint(p, end, count)) return false;
+        long long pid = 0, time = 0;
+        for (uint64_t i = 0; i < count; i++) {
+            uint64_t delta, gap, length;
+            if (!GetVarint(p, end, delta) || !GetVarint(p, end, gap) || !GetVarint(p, end, length)) return false;
+            pid += UnZigZag(delta);
+            if (pid <= 0 || pid > INT32_MAX || gap > INT32_MAX || length == 0 || length > INT32_MAX) return false;
+            lane.Append((int)pid, time + (long long)gap, (long long)length);
+            time += (long long)(gap + length);
+        }
+    }
+    return p == end;
+}
+
+} // namespace
+
+string ResultKey::Hex() const {
+    char text[33];
+    snprintf(text, sizeof(text), "%016llx%016llx", (unsigned long long)hi, (unsigned long long)lo);
+    return text;
+}
+
+ResultCache::ResultCache(const string& directory, uint64_t max_bytes)
+    : m_directory(directory), m_max_bytes(max_bytes) {}
+
+string ResultCache::PathOf(const ResultKey& key) const {
+    return (fs::path(m_directory) / (key.Hex() + kCacheExtension)).string();
+}
+
+ResultKey ResultCache::Key(const ProcessScheduler& workload, SchedulePolicy policy) {
+    ContentHash hash;
+    hash.Add(kCacheVersion);
+    hash.Add(Pack(policy, workload.cpu_count));
+    hash.Add(Pack(workload.per_cpu_queues, workload.work_stealing));
+    hash.Add((uint64_t)workload.balance_interval);
+    // 只计入所选算法用到的参数，改时间片不影响其他算法的缓存
+    if (policy == PolicyRoundRobin) {
+        hash.Add((uint64_t)workload.time_quantum);
+    } else if (policy == PolicyMLFQ) {
+        hash.Add(workload.mlfq_quanta.size());
+        for (int quantum : workload.mlfq_quanta) hash.Add((uint64_t)quantum);
+        hash.Add((uint64_t)workload.mlfq_boost);
+    } else if (policy == PolicyCFS) {
+        hash.Add(Pack(workload.cfs_latency, workload.cfs_min_granularity));
+    }
+
+    // 负载按arrive_queue的顺序计入（到达时间相同的进程按此顺序入队，顺序不同结果可能不同）
+    hash.Add(workload.arrive_queue.size());
+    string name;
+    for (PcbHandle h : workload.arrive_queue) {
+        const ProcessPCB& pro = workload.Pcb(h);
+        hash.Add(Pack(pro.ID, pro.arrive_time));
+        hash.Add(Pack(pro.service_time, pro.priority));
+        hash.Add(Pack(pro.io_start, pro.io_time));
+        hash.Add(pro.burst_count);
+        for (uint32_t i = 0; i < pro.burst_count; i++) {
+            const IoBurst& io = workload.burst_arena[pro.burst_offset + i];
+            hash.Add(Pack(io.start, io.time));
+        }
+        name.clear();
+        EncodeUtf8(pro.name, name);
+        hash.AddBytes(name.data(), name.size());
+    }
+    return hash.Finish();
+}
+
+bool ResultCache::Load(const ResultKey& key, ProcessScheduler& out) {
+    m_error.clear();
+    string path = PathOf(key);
+    error_code ec;
+    if (!fs::is_regular_file(path, ec)) return false;
+
+    vector<CacheRecord> records;
+    vector<Timeline> lanes;
+    const char* names;
+    CacheHeader header;
+    {
+        MappedFile file;
+        if (!file.Open(path)) return false;
+        const char* data = file.Data();
+        bool ok = file.Size() >= sizeof(CacheHeader);
+        if (ok) {
+            memcpy(&header, data, sizeof(header));
+            ok = header.magic == kCacheMagic && header.version == kCacheVersion &&
+                header.key_hi == key.hi && header.key_lo == key.lo &&
+                header.lanes == (uint32_t)out.cpu_count && header.policy >= PolicyFCFS && header.policy <= kLastPolicy &&
+                header.records <= (file.Size() - sizeof(header)) / sizeof(CacheRecord) &&
+                header.names <= file.Size() && header.segments <= file.Size() &&
+                file.Size() == sizeof(header) + header.records * sizeof(CacheRecord) + header.names + header.segments &&
+                Checksum(data + sizeof(header), file.Size() - sizeof(header)) == header.checksum;
+        }
+        if (ok) {
+            const char* body = data + sizeof(header);
+            records.resize((size_t)header.records);
+            if (!records.empty()) memcpy(records.data(), body, records.size() * sizeof(CacheRecord));
+            names = body + records.size() * sizeof(CacheRecord);
+            uint64_t name_bytes = 0;
+            for (const CacheRecord& rec : records) name_bytes += rec.name_length;
+            const char* segments = names + header.names;
+            lanes.assign(header.lanes, Timeline());
+            ok = name_bytes == header.names && DecodeSegments(segments, segments + header.segments, lanes);
+        }
+        if (ok) {
+            // 校验通过后才改动out
+            out.pcb_pool.clear();
+            out.burst_arena.clear();
+            out.arrive_queue.clear();
+            out.arrive_pos = 0;
+            out.finish_queue.clear();
+            out.finish_stats.Clear();
+            out.ResetCpus();
+            out.pcb_pool.resize(records.size());
+            for (size_t i = 0; i < records.size(); i++) {
+                const CacheRecord& rec = records[i];
+                ProcessPCB& pro = out.pcb_pool[i];
+                pro.arrive_time = rec.arrive_time;
+                pro.service_time = rec.service_time;
+                pro.priority = rec.base_priority;
+                pro.io_start = rec.io_start;
+                pro.io_time = rec.io_time;
+                pro.burst_offset = pro.burst_count = 0;
+                out.InitProcess(pro, rec.id);
+                DecodeUtf8(names, names + rec.name_length, pro.name);
+                names += rec.name_length;
+                pro.priority = rec.priority;
+                pro.all_time = 0;
+                pro.cpu_time = rec.service_time;
+                pro.cpu = rec.cpu;
+                pro.start_time = rec.start_time;
+                pro.end_time = rec.end_time;
+                pro.wait_time = rec.wait_time;
+                pro.response_time = rec.response_time;
+                pro.turnaround_time = rec.turnaround_time;
+                pro.io_count = rec.io_count;
+                pro.fair_share = rec.fair_share;
+                pro.state = Finish;
+                out.finish_queue.push_back((PcbHandle)i);
+                out.finish_stats.Record(pro);
+            }
+            out.timelines.swap(lanes);
+            out.policy = (SchedulePolicy)header.policy;
+            out.current_time = header.end_time;
+        } else {
+            m_error = L"缓存条目已损坏，已删除：" + wstring(path.begin(), path.end());
+        }
+    }
+    if (!m_error.empty()) {
+        fs::remove(path, ec);
+        return false;
+    }
+    // 修改时间即最近使用时间
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+bool ResultCache::Store(const ResultKey& key, const ProcessScheduler& finished) {
+    m_error.clear();
+    vector<CacheRecord> records(finished.finish_queue.size());
+    string names, segments;
+    for (size_t i = 0; i < records.size(); i++) {
+        const ProcessPCB& pro = finished.Pcb(finished.finish_queue[i]);
+        CacheRecord& rec = records[i];
+        rec.id = pro.ID;
+        rec.arrive_time = pro.arrive_time;
+        rec.service_time = pro.service_time;
+        rec.priority = pro.priority;
+        rec.base_priority = pro.base_priority;
+        rec.io_start = pro.io_start;
+        rec.io_time = pro.io_time;
+        rec.cpu = pro.cpu;
+        rec.start_time = pro.start_time;
+        rec.end_time = pro.end_time;
+        rec.wait_time = pro.wait_time;
+        rec.response_time = pro.response_time;
+        rec.turnaround_time = pro.turnaround_time;
+        rec.io_count = pro.io_count;
+        size_t before = names.size();
+        EncodeUtf8(pro.name, names);
+        rec.name_length = (uint32_t)(names.size() - before);
+        rec.reserved = 0;
+        rec.fair_share = pro.fair_share;
+    }
+    EncodeSegments(finished.timelines, segments);
+
+    string body(records.size() * sizeof(CacheRecord), '\0');
+    if (!records.empty()) memcpy(&body[0], records.data(), body.size());
+    body += names;
+    body += segments;
+    if (sizeof(CacheHeader) + body.size() > m_max_bytes) {
+        m_error = L"结果超过缓存容量，未保存";
+        return false;
+    }
+    CacheHeader header = { kCacheMagic, kCacheVersion, (uint16_t)finished.policy, key.hi, key.lo,
+        (uint32_t)finished.timelines.size(), finished.current_time, records.size(), names.size(), segments.size(),
+        Checksum(body.data(), body.size()) };
+
+    // 先写临时文件再改名，读者只会看到完整的条目
+    error_code ec;
+    fs::create_directories(m_directory, ec);
+    string path = PathOf(key);
+    string temp = path + ".tmp" + to_string(random_device()());
+    FILE* fp = fopen(temp.c_str(), "wb");
+    if (!fp) {
+        m_error = L"无法写入缓存目录：" + wstring(m_directory.begin(), m_directory.end());
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1 && fwrite(body.data(), 1, body.size(), fp) == body.size();
+    if (fclose(fp) != 0) ok = false;
+    if (ok) fs::rename(temp, path, ec);
+    if (!ok || ec) {
+        fs::remove(temp, ec);
+        m_error = L"写入缓存条目失败：" + wstring(path.begin(), path.end());
+        return false;
+    }
+    Evict(path);
+    return true;
+}
+
+// 按修改时间从旧到新删除条目，直到总大小不超过容量；刚写入的条目保留
+void ResultCache::Evict(const string& keep) {
+    struct Entry {
+        fs::file_time_type used;
+        uint64_t size;
+        fs::path path;
+    };
+    vector<Entry> entries;
+    uint64_t total = 0;
+    error_code ec;
+    for (fs::directory_iterator it(m_directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() != kCacheExtension) continue;
+        error_code entry_ec;
+        Entry entry = { fs::last_write_time(it->path(), entry_ec), fs::file_size(it->path(), entry_ec), it->path() };
+        if (entry_ec) continue;
+        total += entry.size;
+        if (entry.path.string() != keep) entries.push_back(entry);
+    }
+    sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    for (size_t i = 0; i < entries.size() && total > m_max_bytes; i++) {
+        if (fs::remove(entries[i].path, ec)) total -= entries[i].size;
+    }
+}
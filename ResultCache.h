@@ -0,0 +1,44 @@
+// ResultCache.h
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include "ProcessSchedulingSimulator.h"
+
+// 结果缓存的键：负载与算法参数的128位哈希
+struct ResultKey {
+    uint64_t hi, lo;
+
+    std::string Hex() const;
+    bool operator==(const ResultKey& other) const { return hi == other.hi && lo == other.lo; }
+};
+
+// 按内容寻址的模拟结果缓存：目录中每个条目是一个以键命名的文件，保存完成进程的指标
+// （按完成顺序）和变长编码压缩的甘特图段。条目带校验和，读取时校验不通过则删除并按未命中处理；
+// 命中时更新文件的修改时间，写入后按修改时间从旧到新淘汰，直到总大小不超过容量（近似LRU）。
+// 条目先写入临时文件再改名，多个进程共用同一目录时不会读到写了一半的条目。
+class ResultCache {
+public:
+    ResultCache(const std::string& directory, uint64_t max_bytes);
+
+    // 规范化的负载（arrive_queue中各进程的输入字段、后续IO和进程名）、CPU配置、
+    // 算法编号及该算法用到的参数（时间片、MLFQ各级时间片和提升间隔、CFS目标延迟和最小粒度）的哈希
+    static ResultKey Key(const ProcessScheduler& workload, SchedulePolicy policy);
+
+    // 命中时把完成进程、流式统计和甘特图恢复到out（相当于模拟结束后的状态）；
+    // 未命中或条目损坏时返回false，损坏时Error()给出原因
+    bool Load(const ResultKey& key, ProcessScheduler& out);
+
+    // 保存模拟结束后的结果，再淘汰超出容量的旧条目
+    bool Store(const ResultKey& key, const ProcessScheduler& finished);
+
+    const std::wstring& Error() const { return m_error; }
+
+private:
+    std::string PathOf(const ResultKey& key) const;
+    void Evict(const std::string& keep);
+
+    std::string m_directory;
+    uint64_t m_max_bytes;
+    std::wstring m_error;
+};
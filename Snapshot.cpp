@@ -0,0 +1,41 @@
+#include "stdafx.h"
+#include "Snapshot.h"
+#include "ParallelFor.h"
+#include <chrono>
+#include <climits>
+
+using namespace std;
+
+SimulationSnapshot::SimulationSnapshot(const ProcessScheduler& scheduler) {
+    m_state.CopyState(scheduler);
+}
+
+SimulationSnapshot::SimulationSnapshot(ProcessScheduler&& scheduler) {
+    m_state.TakeState(scheduler);
+}
+
+void SimulationSnapshot::Fork(ProcessScheduler& out, const SnapshotBranch& branch) const {
+    out.CopyState(m_state);
+    const ProcessScheduler& settings = *branch.settings;
+    out.time_quantum = settings.time_quantum;
+    out.mlfq_quanta = settings.mlfq_quanta;
+    out.mlfq_boost = settings.mlfq_boost;
+    out.cfs_latency = settings.cfs_latency;
+    out.cfs_min_granularity = settings.cfs_min_granularity;
+    out.SwitchPolicy(branch.policy);
+}
+
+// 每个分支一个任务，由线程池中先空闲的线程领取；耗时只计分叉和快照之后的模拟
+void SimulationSnapshot::RunBranches(const vector<SnapshotBranch>& branches, int threads,
+    vector<PolicyOutcome>& out) const {
+    out.assign(branches.size(), PolicyOutcome());
+    ParallelFor(branches.size(), threads, [&](size_t i) {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        ProcessScheduler scheduler;
+        Fork(scheduler, branches[i]);
+        scheduler.quiet = true;
+        scheduler.RunUntil(LLONG_MAX);
+        out[i] = PolicyComparison::Summarize(scheduler, branches[i].policy,
+            chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    });
+}
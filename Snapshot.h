@@ -0,0 +1,38 @@
+// Snapshot.h
+#pragma once
+
+#include <vector>
+#include "ProcessSchedulingSimulator.h"
+#include "PolicyComparison.h"
+
+// 分叉的一个分支：接手的算法，时间片、MLFQ和CFS参数取自settings（只读）
+struct SnapshotBranch {
+    SchedulePolicy policy;
+    const ProcessScheduler* settings;
+};
+
+// 模拟快照：调度器在某一时刻的全部模拟状态，包括PCB、到达/就绪/阻塞/完成队列、各CPU的运行进程、
+// 时钟、流式统计和到此为止的甘特图。状态都存放在按句柄索引的数组中，分叉是整块复制，
+// 不重放之前的模拟；前段的调度器不再需要时可直接移交给快照，取快照不复制。快照创建后只读，多个线程可以同时从同一快照分叉，
+// 因此"从T时刻起换成X算法会怎样"只需把T之前的部分模拟一次。
+class SimulationSnapshot {
+public:
+    // 复制scheduler的当前状态，scheduler应停在RunUntil返回的时刻边界上
+    explicit SimulationSnapshot(const ProcessScheduler& scheduler);
+    // 接过scheduler的状态而不复制，之后scheduler不应再使用
+    explicit SimulationSnapshot(ProcessScheduler&& scheduler);
+
+    // 快照所在的时刻（该时刻尚未处理）
+    int Time() const { return m_state.current_time; }
+    const ProcessScheduler& State() const { return m_state; }
+
+    // out复制快照的状态，换上分支的参数后改用分支的算法，之后由out.RunUntil接着推进
+    void Fork(ProcessScheduler& out, const SnapshotBranch& branch) const;
+
+    // 各分支在自己的线程中分叉并模拟到结束，结果按branches的顺序返回，threads为0时按硬件线程数
+    void RunBranches(const std::vector<SnapshotBranch>& branches, int threads,
+        std::vector<PolicyOutcome>& out) const;
+
+private:
+    ProcessScheduler m_state;
+};
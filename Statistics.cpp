@@ -0,0 +1,140 @@
+#include "stdafx.h"
+#include "Statistics.h"
+#include "ProcessSchedulingSimulator.h"
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+namespace {
+
+// 双侧95%的t分布分位数，自由度1到30
+const double kStudentT95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+// 自由度更大时用正态分位数加一阶修正 z + (z^3 + z) / (4df)
+double StudentT95(long long df) {
+    if (df <= 30) return kStudentT95[df - 1];
+    const double z = 1.959964;
+    return z + (z * z * z + z) / (4.0 * df);
+}
+
+const int kExactBits = 8;                          // 小于2^8的值精确计数
+const uint64_t kExact = 1ULL << kExactBits;
+const uint64_t kHalf = kExact / 2;                 // 之后每翻一倍的桶数
+
+int HighestBit(uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) bit++;
+    return bit;
+}
+
+void PrintMetricQuantiles(const wchar_t* title, const MetricStats& metric) {
+    wcout << title << metric.Quantile(0.5) << L" / " << metric.Quantile(0.9) << L" / "
+        << metric.Quantile(0.99) << L" / " << metric.Quantile(0.999) << L"\n";
+}
+
+} // namespace
+
+void RunningStat::Merge(const RunningStat& other) {
+    if (other.m_count == 0) return;
+    if (m_count == 0) {
+        *this = other;
+        return;
+    }
+    long long count = m_count + other.m_count;
+    double delta = other.m_mean - m_mean;
+    m_m2 += other.m_m2 + delta * delta * ((double)m_count * other.m_count / count);
+    m_mean += delta * other.m_count / count;
+    m_sum += other.m_sum;
+    m_count = count;
+}
+
+double RunningStat::Stddev() const {
+    return m_count > 1 ? sqrt(m_m2 / (m_count - 1)) : 0;
+}
+
+double RunningStat::HalfWidth95() const {
+    return m_count > 1 ? StudentT95(m_count - 1) * Stddev() / sqrt((double)m_count) : 0;
+}
+
+size_t HdrHistogram::IndexOf(uint64_t value) {
+    if (value < kExact) return (size_t)value;
+    int shift = HighestBit(value) - (kExactBits - 1);
+    return (size_t)(kExact + (shift - 1) * kHalf + ((value >> shift) - kHalf));
+}
+
+uint64_t HdrHistogram::LowerBound(size_t index) {
+    if (index < kExact) return index;
+    uint64_t k = index - kExact;
+    int shift = (int)(k / kHalf) + 1;
+    return (k % kHalf + kHalf) << shift;
+}
+
+void HdrHistogram::Record(uint64_t value) {
+    size_t index = IndexOf(value);
+    if (index >= m_counts.size()) m_counts.resize(index + 1, 0);
+    m_counts[index]++;
+    m_count++;
+    if (value < m_min) m_min = value;
+    if (value > m_max) m_max = value;
+}
+
+void HdrHistogram::Merge(const HdrHistogram& other) {
+    if (other.m_counts.size() > m_counts.size()) m_counts.resize(other.m_counts.size(), 0);
+    for (size_t i = 0; i < other.m_counts.size(); i++) m_counts[i] += other.m_counts[i];
+    m_count += other.m_count;
+    if (other.m_min < m_min) m_min = other.m_min;
+    if (other.m_max > m_max) m_max = other.m_max;
+}
+
+uint64_t HdrHistogram::ValueAtQuantile(double q) const {
+    if (m_count == 0) return 0;
+    long long rank = (long long)ceil(q * m_count);
+    if (rank <= 1) return m_min;
+    if (rank >= m_count) return m_max;
+    long long seen = 0;
+    for (size_t i = 0; i < m_counts.size(); i++) {
+        seen += m_counts[i];
+        if (seen >= rank) {
+            uint64_t value = LowerBound(i);
+            if (value < m_min) value = m_min;
+            return value < m_max ? value : m_max;
+        }
+    }
+    return m_max;
+}
+
+void FinishStatistics::Record(const ProcessPCB& pro) {
+    wait.Add(pro.wait_time);
+    response.Add(pro.response_time);
+    turnaround.Add(pro.turnaround_time);
+    weighted.Add((double)pro.turnaround_time / pro.service_time);
+}
+
+void FinishStatistics::Merge(const FinishStatistics& other) {
+    wait.Merge(other.wait);
+    response.Merge(other.response);
+    turnaround.Merge(other.turnaround);
+    weighted.Merge(other.weighted);
+}
+
+void ScheduleAccumulator::Record(const ProcessPCB& pro) {
+    all.Record(pro);
+    by_priority[pro.base_priority].Record(pro);
+}
+
+void ScheduleAccumulator::Merge(const ScheduleAccumulator& other) {
+    all.Merge(other.all);
+    for (const auto& entry : other.by_priority) by_priority[entry.first].Merge(entry.second);
+}
+
+void PrintQuantiles(const FinishStatistics& stats) {
+    PrintMetricQuantiles(L"等待时间：", stats.wait);
+    PrintMetricQuantiles(L"响应时间：", stats.response);
+    PrintMetricQuantiles(L"周转时间：", stats.turnaround);
+    PrintMetricQuantiles(L"带权周转时间：", stats.weighted);
+}
@@ -0,0 +1,113 @@
+// Statistics.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+struct ProcessPCB;
+
+// 逐个加入样本，用Welford算法累计方差（不保存样本，数值稳定），均值按总和计算
+// 两个累计器可以合并（Chan等人的并行公式），用于多线程分别统计后汇总
+class RunningStat {
+public:
+    RunningStat() : m_count(0), m_mean(0), m_m2(0), m_sum(0) {}
+
+    void Add(double x) {
+        m_count++;
+        double delta = x - m_mean;
+        m_mean += delta / m_count;
+        m_m2 += delta * (x - m_mean);
+        m_sum += x;
+    }
+
+    void Merge(const RunningStat& other);
+
+    long long Count() const { return m_count; }
+    double Mean() const { return m_count ? m_sum / m_count : 0; }
+    double Stddev() const;               // 样本标准差（n-1），少于2个样本时为0
+    double HalfWidth95() const;          // 均值95%置信区间的半宽，按t分布
+
+private:
+    long long m_count;
+    double m_mean;
+    double m_m2;
+    double m_sum;
+};
+
+// HDR直方图：非负整数按对数分组、组内线性细分，相对误差不超过1/128
+// 小于256的值精确计数；更大的值每翻一倍用128个桶。计数数组只增长到记录过的最大值所在的组，
+// 内存只与取值范围有关，与样本数无关。合并即逐桶相加，结果与合并顺序无关。
+class HdrHistogram {
+public:
+    HdrHistogram() : m_count(0), m_min(UINT64_MAX), m_max(0) {}
+
+    void Record(uint64_t value);
+    void Merge(const HdrHistogram& other);
+
+    long long Count() const { return m_count; }
+
+    // 第q分位数（q在[0, 1]）：排在第ceil(q*n)位的样本所在桶的下界，限制在记录过的最小值和最大值之间；
+    // 第一位和最后一位直接返回精确的最小值和最大值
+    uint64_t ValueAtQuantile(double q) const;
+
+private:
+    static size_t IndexOf(uint64_t value);
+    static uint64_t LowerBound(size_t index);
+
+    std::vector<long long> m_counts;
+    long long m_count;
+    uint64_t m_min, m_max;
+};
+
+// 一项指标的流式统计：均值和方差，以及按scale放大取整后记入直方图的分位数
+class MetricStats {
+public:
+    explicit MetricStats(double scale = 1) : m_scale(scale) {}
+
+    void Add(double x) {
+        m_moments.Add(x);
+        m_histogram.Record(x > 0 ? (uint64_t)(x * m_scale + 0.5) : 0);
+    }
+
+    void Merge(const MetricStats& other) {
+        m_moments.Merge(other.m_moments);
+        m_histogram.Merge(other.m_histogram);
+    }
+
+    const RunningStat& Moments() const { return m_moments; }
+    double Quantile(double q) const { return m_histogram.ValueAtQuantile(q) / m_scale; }
+
+private:
+    double m_scale;
+    RunningStat m_moments;
+    HdrHistogram m_histogram;
+};
+
+// 完成进程的等待、响应、周转和带权周转时间，进程完成时逐个记入，内存与进程数无关
+struct FinishStatistics {
+    MetricStats wait, response, turnaround, weighted;
+
+    FinishStatistics() : weighted(1000) {}  // 带权周转时间按千分之一记入直方图
+
+    void Record(const ProcessPCB& pro);
+    void Merge(const FinishStatistics& other);
+    long long Count() const { return wait.Moments().Count(); }
+};
+
+// 全部进程和按优先级分类的统计
+struct ScheduleAccumulator {
+    FinishStatistics all;
+    std::map<int, FinishStatistics> by_priority;
+
+    void Clear() {
+        all = FinishStatistics();
+        by_priority.clear();
+    }
+    void Record(const ProcessPCB& pro);
+    void Merge(const ScheduleAccumulator& other);
+};
+
+// 输出p50、p90、p99和p99.9
+void PrintQuantiles(const FinishStatistics& stats);
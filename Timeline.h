@@ -0,0 +1,140 @@
+// Timeline.h
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+// 甘特图中的一段：进程pid在[start, end)内连续占用CPU，pid为kIdlePid表示CPU空闲
+struct TimelineSegment {
+    int pid;
+    long long start, end;
+};
+
+const int kIdlePid = -1;
+
+// 游程编码的调度时间线
+// 由调度核心按时间顺序追加，相邻的同一进程合并为一段，中间的空隙记为空闲段，
+// 占用内存只与上下文切换次数有关，与模拟时长无关。
+// 按进程的区间查询另需各进程的段下标和此前累计的CPU时间，这一索引在第一次查询时才补建，
+// 追加段时不维护（模拟和读取缓存的结果时都不需要为它付出代价）。
+class Timeline {
+public:
+    Timeline() : m_end(0), m_indexed(0) {}
+
+    void Clear() {
+        m_segments.clear();
+        m_lanes.clear();
+        m_lane_of.clear();
+        m_end = 0;
+        m_indexed = 0;
+    }
+
+    bool empty() const { return m_segments.empty(); }
+    const std::vector<TimelineSegment>& Segments() const { return m_segments; }
+    long long EndTime() const { return m_end; }
+
+    // 记录进程pid从start开始运行len个时间单位（start不得早于已记录的结束时间）
+    void Append(int pid, long long start, long long len) {
+        if (len <= 0) return;
+        if (start > m_end) Push(kIdlePid, m_end, start);
+        if (!m_segments.empty() && m_segments.back().pid == pid && m_segments.back().end == start) {
+            m_segments.back().end = start + len;
+        } else {
+            Push(pid, start, start + len);
+        }
+        m_end = start + len;
+    }
+
+    // [t0, t1)内运行过的进程段（已裁剪到区间内，不含空闲段）
+    void Query(long long t0, long long t1, std::vector<TimelineSegment>& out) const {
+        for (size_t i = FirstEndingAfter(t0); i < m_segments.size(); i++) {
+            const TimelineSegment& seg = m_segments[i];
+            if (seg.start >= t1) break;
+            if (seg.pid == kIdlePid) continue;
+            TimelineSegment clipped = { seg.pid, std::max(seg.start, t0), std::min(seg.end, t1) };
+            out.push_back(clipped);
+        }
+    }
+
+    // t时刻正在运行的进程，空闲或超出时间线时返回kIdlePid
+    int RunningAt(long long t) const {
+        size_t i = FirstEndingAfter(t);
+        if (i == m_segments.size() || m_segments[i].start > t) return kIdlePid;
+        return m_segments[i].pid;
+    }
+
+    // 进程pid在[t0, t1)内占用CPU的时间（会补建索引，同一时间线不能在多个线程中同时查询）
+    long long CpuTime(int pid, long long t0, long long t1) const {
+        if (t0 >= t1) return 0;
+        Index();
+        auto it = m_lane_of.find(pid);
+        if (it == m_lane_of.end()) return 0;
+        const Lane& lane = m_lanes[it->second];
+
+        // 该进程的段按时间有序，二分找出与区间相交的第一段和最后一段
+        size_t first = std::partition_point(lane.segs.begin(), lane.segs.end(),
+            [&](size_t i) { return m_segments[i].end <= t0; }) - lane.segs.begin();
+        size_t last = std::partition_point(lane.segs.begin(), lane.segs.end(),
+            [&](size_t i) { return m_segments[i].start < t1; }) - lane.segs.begin();
+        if (first >= last) return 0;
+
+        const TimelineSegment& a = m_segments[lane.segs[first]];
+        const TimelineSegment& b = m_segments[lane.segs[last - 1]];
+        long long total = lane.before[last - 1] + (b.end - b.start) - lane.before[first];
+        if (a.start < t0) total -= t0 - a.start;
+        if (b.end > t1) total -= b.end - t1;
+        return total;
+    }
+
+    // 进程pid的总CPU时间
+    long long CpuTime(int pid) const {
+        return CpuTime(pid, 0, m_end);
+    }
+
+private:
+    // 单个进程的段下标，before[k]为第k段之前该进程累计的CPU时间
+    struct Lane {
+        std::vector<size_t> segs;
+        std::vector<long long> before;
+    };
+
+    void Push(int pid, long long start, long long end) {
+        TimelineSegment seg = { pid, start, end };
+        m_segments.push_back(seg);
+    }
+
+    // 把上次查询之后追加的段加入各进程的索引。最后一个已索引的段之后可能被合并延长，
+    // 但它的before只与更早的段有关，之后的段计算before时读取的是延长后的长度
+    void Index() const {
+        for (; m_indexed < m_segments.size(); m_indexed++) {
+            int pid = m_segments[m_indexed].pid;
+            if (pid == kIdlePid) continue;
+            auto it = m_lane_of.find(pid);
+            if (it == m_lane_of.end()) {
+                it = m_lane_of.emplace(pid, m_lanes.size()).first;
+                m_lanes.push_back(Lane());
+            }
+            Lane& lane = m_lanes[it->second];
+            long long before = 0;
+            if (!lane.segs.empty()) {
+                const TimelineSegment& prev = m_segments[lane.segs.back()];
+                before = lane.before.back() + (prev.end - prev.start);
+            }
+            lane.segs.push_back(m_indexed);
+            lane.before.push_back(before);
+        }
+    }
+
+    // 第一个结束时间晚于t的段
+    size_t FirstEndingAfter(long long t) const {
+        return std::partition_point(m_segments.begin(), m_segments.end(),
+            [t](const TimelineSegment& seg) { return seg.end <= t; }) - m_segments.begin();
+    }
+
+    std::vector<TimelineSegment> m_segments;
+    mutable std::vector<Lane> m_lanes;
+    mutable std::unordered_map<int, size_t> m_lane_of;  // 进程ID -> m_lanes下标
+    long long m_end;
+    mutable size_t m_indexed;  // 已加入索引的段数
+};
@@ -0,0 +1,157 @@
+// TimingWheel.h
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <climits>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 64位掩码中最低置位的下标
+inline int LowestSetBit(uint64_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+// 分层时间轮：按绝对唤醒轮次存放阻塞进程
+// 每层64个槽，第l层的一个槽覆盖64^l个轮次；超出最高层范围的条目放在溢出表中。
+// 推进时只把覆盖当前轮次的高层槽向下拆分，到期时只取出当轮唤醒的条目，
+// 同一轮唤醒的条目按插入先后输出。
+template <typename T>
+class TimingWheel {
+public:
+    TimingWheel() : m_now(0), m_size(0), m_seq(0) {
+        for (int l = 0; l < kLevels; l++) m_bitmap[l] = 0;
+    }
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+
+    // 清空并把当前轮次设为now
+    void Reset(long long now) {
+        for (int l = 0; l < kLevels; l++) {
+            for (int s = 0; s < kSlots; s++) m_slots[l][s].clear();
+            m_bitmap[l] = 0;
+        }
+        m_overflow.clear();
+        m_now = now;
+        m_size = 0;
+        m_seq = 0;
+    }
+
+    // 登记在wake轮次唤醒的条目（wake必须不早于当前轮次）
+    void Insert(long long wake, const T& item) {
+        Entry entry;
+        entry.wake = wake < m_now ? m_now : wake;
+        entry.seq = m_seq++;
+        entry.item = item;
+        File(entry);
+        m_size++;
+    }
+
+    // 推进到now轮次并取出当轮唤醒的条目；调用方保证不会越过尚未取出的唤醒轮次
+    void PopDue(long long now, std::vector<T>& out) {
+        AdvanceTo(now);
+        int slot = (int)(now & kMask);
+        std::vector<Entry>& bucket = m_slots[0][slot];
+        if (bucket.empty()) return;
+        std::sort(bucket.begin(), bucket.end(),
+            [](const Entry& a, const Entry& b) { return a.seq < b.seq; });
+        for (Entry& entry : bucket) out.push_back(entry.item);
+        m_size -= bucket.size();
+        bucket.clear();
+        m_bitmap[0] &= ~(1ULL << slot);
+    }
+
+    // 下一个可能有条目唤醒的轮次（下界）；高层槽给出其覆盖范围的起点，
+    // 推进到该轮次后会被拆分到低层，从而逐步收敛到准确的唤醒轮次
+    long long NextWake() const {
+        if (m_size == 0) return LLONG_MAX;
+        for (int l = 0; l < kLevels; l++) {
+            if (m_bitmap[l] == 0) continue;
+            int shift = l * kBits;
+            long long base = (m_now >> shift >> kBits) << kBits;
+            long long start = (base + LowestSetBit(m_bitmap[l])) << shift;
+            return start > m_now ? start : m_now;
+        }
+        long long next = LLONG_MAX;
+        for (const Entry& entry : m_overflow) next = std::min(next, entry.wake);
+        return next;
+    }
+
+    // 按插入先后遍历全部条目（仅用于输出）
+    template <typename F>
+    void ForEach(F visit) const {
+        std::vector<const Entry*> entries;
+        for (int l = 0; l < kLevels; l++)
+            for (int s = 0; s < kSlots; s++)
+                for (const Entry& entry : m_slots[l][s]) entries.push_back(&entry);
+        for (const Entry& entry : m_overflow) entries.push_back(&entry);
+        std::sort(entries.begin(), entries.end(),
+            [](const Entry* a, const Entry* b) { return a->seq < b->seq; });
+        for (const Entry* entry : entries) visit(entry->item);
+    }
+
+private:
+    static const int kBits = 6;
+    static const int kSlots = 1 << kBits;
+    static const long long kMask = kSlots - 1;
+    static const int kLevels = 6;
+
+    struct Entry {
+        long long wake;
+        long long seq;
+        T item;
+    };
+
+    // 按与当前轮次相同的最长前缀决定所在层
+    void File(const Entry& entry) {
+        for (int l = 0; l < kLevels; l++) {
+            int shift = l * kBits;
+            if ((entry.wake >> shift >> kBits) == (m_now >> shift >> kBits)) {
+                int slot = (int)((entry.wake >> shift) & kMask);
+                m_slots[l][slot].push_back(entry);
+                m_bitmap[l] |= 1ULL << slot;
+                return;
+            }
+        }
+        m_overflow.push_back(entry);
+    }
+
+    // 推进当前轮次，把覆盖新轮次的高层槽拆分到低层
+    void AdvanceTo(long long now) {
+        if (now <= m_now) return;
+        long long old = m_now;
+        m_now = now;
+
+        if ((now >> (kLevels * kBits)) != (old >> (kLevels * kBits)) && !m_overflow.empty()) {
+            std::vector<Entry> overflow;
+            overflow.swap(m_overflow);
+            for (const Entry& entry : overflow) File(entry);
+        }
+        for (int l = kLevels - 1; l >= 1; l--) {
+            int shift = l * kBits;
+            if ((now >> shift) == (old >> shift)) continue;
+            int slot = (int)((now >> shift) & kMask);
+            if (!(m_bitmap[l] & (1ULL << slot))) continue;
+            std::vector<Entry> bucket;
+            bucket.swap(m_slots[l][slot]);
+            m_bitmap[l] &= ~(1ULL << slot);
+            for (const Entry& entry : bucket) File(entry);
+        }
+    }
+
+    long long m_now;
+    size_t m_size;
+    long long m_seq;
+    std::vector<Entry> m_slots[kLevels][kSlots];
+    uint64_t m_bitmap[kLevels];
+    std::vector<Entry> m_overflow;
+};
@@ -0,0 +1,79 @@
+// Utf8.h
+#pragma once
+
+#include <string>
+
+// UTF-8与宽字符串互转（wchar_t为16位时按UTF-16处理代理对）
+
+// 追加一个Unicode码点
+inline void AppendCodePoint(std::wstring& out, unsigned cp) {
+    if (sizeof(wchar_t) == 2 && cp > 0xFFFF) {
+        cp -= 0x10000;
+        out.push_back((wchar_t)(0xD800 + (cp >> 10)));
+        out.push_back((wchar_t)(0xDC00 + (cp & 0x3FF)));
+    } else {
+        out.push_back((wchar_t)cp);
+    }
+}
+
+// UTF-8解码，非法字节按单字节原样保留
+inline void DecodeUtf8(const char* p, const char* end, std::wstring& out) {
+    out.clear();
+    while (p < end) {
+        unsigned char c = (unsigned char)*p;
+        if (c < 0x80) {
+            out.push_back((wchar_t)c);
+            p++;
+            continue;
+        }
+        int extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+        if (extra == 0 || end - p <= extra) {
+            out.push_back((wchar_t)c);
+            p++;
+            continue;
+        }
+        unsigned cp = c & (0x3F >> extra);
+        bool ok = true;
+        for (int i = 1; i <= extra; i++) {
+            unsigned char d = (unsigned char)p[i];
+            if ((d & 0xC0) != 0x80) { ok = false; break; }
+            cp = (cp << 6) | (d & 0x3F);
+        }
+        if (!ok) {
+            out.push_back((wchar_t)c);
+            p++;
+            continue;
+        }
+        AppendCodePoint(out, cp);
+        p += extra + 1;
+    }
+}
+
+// 宽字符串编码为UTF-8，追加到out
+inline void EncodeUtf8(const std::wstring& in, std::string& out) {
+    for (size_t i = 0; i < in.size(); i++) {
+        unsigned cp = (unsigned)in[i];
+        if (sizeof(wchar_t) == 2 && cp >= 0xD800 && cp < 0xDC00 && i + 1 < in.size()) {
+            unsigned low = (unsigned)in[i + 1];
+            if (low >= 0xDC00 && low < 0xE000) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                i++;
+            }
+        }
+        if (cp < 0x80) {
+            out.push_back((char)cp);
+        } else if (cp < 0x800) {
+            out.push_back((char)(0xC0 | (cp >> 6)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back((char)(0xE0 | (cp >> 12)));
+            out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back((char)(0xF0 | (cp >> 18)));
+            out.push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        }
+    }
+}
@@ -0,0 +1,311 @@
+#include "stdafx.h"
+#include "WorkloadGenerator.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <climits>
+#include <cstdint>
+
+using namespace std;
+
+namespace {
+
+const size_t kChunkSize = 1 << 16;
+const double kMaxTime = 1e9;  // 单个时间量的上限，保证每个字段放得进int（总时长由调度器在模拟前检查）
+
+// 随机数流编号：到达时间单独一条流，便于只重放到达过程求出每块的时长
+const uint64_t kArrivalStream = 1;
+const uint64_t kAttributeStream = 2;
+
+uint64_t SplitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// xoshiro256**，状态由种子、块号和流编号经SplitMix64展开
+class Random {
+public:
+    Random(uint64_t seed, uint64_t chunk, uint64_t stream) {
+        uint64_t state = seed ^ (chunk * 0xD1B54A32D192ED03ULL) ^ (stream * 0x8CB92BA72F3D8DD7ULL);
+        for (int i = 0; i < 4; i++) m_s[i] = SplitMix64(state);
+    }
+
+    uint64_t Next() {
+        uint64_t result = Rotl(m_s[1] * 5, 7) * 9;
+        uint64_t t = m_s[1] << 17;
+        m_s[2] ^= m_s[0];
+        m_s[3] ^= m_s[1];
+        m_s[1] ^= m_s[2];
+        m_s[0] ^= m_s[3];
+        m_s[2] ^= t;
+        m_s[3] = Rotl(m_s[3], 45);
+        return result;
+    }
+
+    // [0, 1)均匀分布
+    double Uniform() { return (Next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    // 均值为mean的指数分布
+    double Exponential(double mean) { return -mean * log(1.0 - Uniform()); }
+
+    // [0, n)上的整数
+    int Below(int n) { return (int)((Next() >> 33) % (uint64_t)n); }
+
+private:
+    static uint64_t Rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    uint64_t m_s[4];
+};
+
+// 向上取整到[1, kMaxTime]
+int ToTime(double x) {
+    double t = ceil(x);
+    if (t < 1) t = 1;
+    if (t > kMaxTime) t = kMaxTime;
+    return (int)t;
+}
+
+// 逐个给出到达时刻（相对本块起点）
+class ArrivalClock {
+public:
+    ArrivalClock(const GeneratorConfig& config, size_t chunk)
+        : m_config(config), m_random(config.seed, chunk, kArrivalStream), m_time(0), m_left_in_burst(0) {}
+
+    double Next() {
+        if (m_config.arrival == ArrivalPoisson) {
+            m_time += m_random.Exponential(1.0 / m_config.arrival_rate);
+            return m_time;
+        }
+        if (m_left_in_burst == 0) {
+            m_time += m_random.Exponential(m_config.burst_size / m_config.arrival_rate);
+            m_left_in_burst = 1;
+            if (m_config.burst_size > 1) {
+                double q = 1.0 - 1.0 / m_config.burst_size;  // 几何分布，均值burst_size
+                m_left_in_burst += (long long)floor(log(1.0 - m_random.Uniform()) / log(q));
+            }
+        }
+        m_left_in_burst--;
+        return m_time;
+    }
+
+private:
+    const GeneratorConfig& m_config;
+    Random m_random;
+    double m_time;
+    long long m_left_in_burst;
+};
+
+bool ParseNumber(const string& text, double& value) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    value = strtod(text.c_str(), &end);
+    return *end == '\0';
+}
+
+} // namespace
+
+GeneratorConfig::GeneratorConfig()
+    : count(1000), seed(1), threads(0),
+      arrival(ArrivalPoisson), arrival_rate(0.5), burst_size(8),
+      service(ServiceExponential), service_mean(4), pareto_alpha(1.5),
+      long_fraction(0.1), long_mean(40),
+      priority_weights(5, 1.0),
+      io_probability(0.2), io_mean(3), io_bursts(1) {}
+
+WorkloadGenerator::WorkloadGenerator(const GeneratorConfig& config) : m_config(config) {
+    double sum = 0;
+    for (double w : m_config.priority_weights) {
+        sum += w;
+        m_priority_cdf.push_back(sum);
+    }
+    for (double& c : m_priority_cdf) c /= sum;
+}
+
+size_t WorkloadGenerator::ChunkCount() const {
+    return (m_config.count + kChunkSize - 1) / kChunkSize;
+}
+
+// 块的时长：最后一个进程相对块起点的到达时刻
+double WorkloadGenerator::ChunkDuration(size_t chunk) const {
+    size_t n = min(kChunkSize, m_config.count - chunk * kChunkSize);
+    ArrivalClock clock(m_config, chunk);
+    double t = 0;
+    for (size_t i = 0; i < n; i++) t = clock.Next();
+    return t;
+}
+
+// 生成第chunk块；第二次及以后的IO放入本块自己的bursts，burst_offset是块内偏移
+void WorkloadGenerator::FillChunk(size_t chunk, double start, ProcessPCB* out, vector<IoBurst>& bursts) const {
+    size_t n = min(kChunkSize, m_config.count - chunk * kChunkSize);
+    ArrivalClock clock(m_config, chunk);
+    Random random(m_config.seed, chunk, kAttributeStream);
+    vector<IoBurst> io(m_config.io_bursts);
+
+    for (size_t i = 0; i < n; i++) {
+        ProcessPCB& pro = out[i];
+        pro.arrive_time = (int)min(floor(start + clock.Next()), (double)INT_MAX);
+
+        double service = 0;
+        switch (m_config.service) {
+        case ServiceExponential:
+            service = random.Exponential(m_config.service_mean);
+            break;
+        case ServicePareto: {
+            double alpha = m_config.pareto_alpha;
+            double scale = alpha > 1 ? m_config.service_mean * (alpha - 1) / alpha : m_config.service_mean;
+            service = scale / pow(1.0 - random.Uniform(), 1.0 / alpha);
+            break;
+        }
+        case ServiceBimodal:
+            service = random.Uniform() < m_config.long_fraction
+                ? random.Exponential(m_config.long_mean)
+                : random.Exponential(m_config.service_mean);
+            break;
+        }
+        pro.service_time = ToTime(service);
+
+        double u = random.Uniform();
+        pro.priority = (int)(upper_bound(m_priority_cdf.begin(), m_priority_cdf.end() - 1, u) - m_priority_cdf.begin()) + 1;
+
+        // 各次IO在服务期间的某个时间点开始，按开始位置排列后第一次放在PCB中
+        pro.burst_offset = (uint32_t)bursts.size();
+        pro.burst_count = 0;
+        if (random.Uniform() < m_config.io_probability) {
+            for (IoBurst& burst : io) {
+                burst.start = random.Below(pro.service_time);
+                burst.time = ToTime(random.Exponential(m_config.io_mean));
+            }
+            stable_sort(io.begin(), io.end(), [](const IoBurst& a, const IoBurst& b) { return a.start < b.start; });
+            pro.io_start = io[0].start;
+            pro.io_time = io[0].time;
+            bursts.insert(bursts.end(), io.begin() + 1, io.end());
+            pro.burst_count = (uint32_t)(io.size() - 1);
+        } else {
+            pro.io_start = -1;
+            pro.io_time = 0;
+        }
+    }
+}
+
+bool WorkloadGenerator::Generate(vector<ProcessPCB>& out, vector<IoBurst>& bursts, wstring& error) const {
+    size_t first = out.size();
+    size_t chunks = ChunkCount();
+    out.resize(first + m_config.count);
+
+    // 先求各块时长得到每块的起始时刻，再以块为单位并行填写
+    vector<double> start(chunks + 1, 0.0);
+    ParallelFor(chunks, m_config.threads, [&](size_t c) { start[c + 1] = ChunkDuration(c); });
+    for (size_t c = 0; c < chunks; c++) start[c + 1] += start[c];
+    vector<vector<IoBurst>> chunk_bursts(chunks);
+    ParallelFor(chunks, m_config.threads,
+        [&](size_t c) { FillChunk(c, start[c], &out[first + c * kChunkSize], chunk_bursts[c]); });
+
+    // burst_offset是32位的，IO总数超出时不追加任何进程
+    size_t total = bursts.size();
+    for (const vector<IoBurst>& chunk : chunk_bursts) total += chunk.size();
+    if (total > UINT32_MAX) {
+        out.resize(first);
+        error = L"IO总次数超出范围";
+        return false;
+    }
+
+    // 各块的IO依次接到bursts之后，块内偏移加上该块在bursts中的起点
+    bursts.reserve(total);
+    for (size_t c = 0; c < chunks; c++) {
+        if (chunk_bursts[c].empty()) continue;
+        uint32_t base = (uint32_t)bursts.size();
+        size_t end = min(first + (c + 1) * kChunkSize, out.size());
+        for (size_t i = first + c * kChunkSize; i < end; i++) out[i].burst_offset += base;
+        bursts.insert(bursts.end(), chunk_bursts[c].begin(), chunk_bursts[c].end());
+    }
+    return true;
+}
+
+bool WorkloadGenerator::IsSpec(const string& spec) {
+    return spec.compare(0, 4, "gen:") == 0;
+}
+
+bool WorkloadGenerator::ParseSpec(const string& spec, GeneratorConfig& config, wstring& error) {
+    if (!IsSpec(spec)) {
+        error = L"负载描述应以gen:开头";
+        return false;
+    }
+    size_t pos = 4;
+    while (pos < spec.size()) {
+        size_t comma = spec.find(',', pos);
+        if (comma == string::npos) comma = spec.size();
+        string item = spec.substr(pos, comma - pos);
+        pos = comma + 1;
+        if (item.empty()) continue;
+
+        size_t eq = item.find('=');
+        string key = item.substr(0, eq);
+        string value = eq == string::npos ? "" : item.substr(eq + 1);
+        wstring wkey(key.begin(), key.end());
+        double number = 0;
+        bool numeric = ParseNumber(value, number);
+
+        if (key == "arrival") {
+            if (value == "poisson") config.arrival = ArrivalPoisson;
+            else if (value == "bursty") config.arrival = ArrivalBursty;
+            else { error = L"arrival应为poisson或bursty"; return false; }
+        } else if (key == "service") {
+            if (value == "exp") config.service = ServiceExponential;
+            else if (value == "pareto") config.service = ServicePareto;
+            else if (value == "bimodal") config.service = ServiceBimodal;
+            else { error = L"service应为exp、pareto或bimodal"; return false; }
+        } else if (key == "priority") {
+            // 以冒号分隔的权重，依次对应优先级1、2、3……
+            vector<double> weights;
+            double sum = 0;
+            size_t p = 0;
+            while (p <= value.size()) {
+                size_t colon = value.find(':', p);
+                if (colon == string::npos) colon = value.size();
+                double w;
+                if (!ParseNumber(value.substr(p, colon - p), w) || w < 0) {
+                    error = L"priority应为以冒号分隔的非负权重";
+                    return false;
+                }
+                weights.push_back(w);
+                sum += w;
+                p = colon + 1;
+            }
+            if (sum <= 0) { error = L"priority权重之和必须大于0"; return false; }
+            config.priority_weights = weights;
+        } else if (!numeric) {
+            error = L"参数" + wkey + L"的值无效";
+            return false;
+        } else if (key == "count" && number >= 0) {
+            config.count = (size_t)number;
+        } else if (key == "seed") {
+            config.seed = strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "threads" && number >= 0) {
+            config.threads = (int)number;
+        } else if (key == "rate" && number > 0) {
+            config.arrival_rate = number;
+        } else if (key == "burst" && number >= 1) {
+            config.burst_size = number;
+        } else if (key == "mean" && number > 0) {
+            config.service_mean = number;
+        } else if (key == "alpha" && number > 0) {
+            config.pareto_alpha = number;
+        } else if (key == "long_fraction" && number >= 0 && number <= 1) {
+            config.long_fraction = number;
+        } else if (key == "long_mean" && number > 0) {
+            config.long_mean = number;
+        } else if (key == "io" && number >= 0 && number <= 1) {
+            config.io_probability = number;
+        } else if (key == "io_mean" && number > 0) {
+            config.io_mean = number;
+        } else if (key == "io_bursts" && number >= 1 && number <= 1000) {
+            config.io_bursts = (int)number;
+        } else {
+            error = L"未知参数或取值超出范围：" + wkey;
+            return false;
+        }
+    }
+    return true;
+}
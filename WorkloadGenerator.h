@@ -0,0 +1,69 @@
+// WorkloadGenerator.h
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "ProcessSchedulingSimulator.h"
+
+// 到达过程
+enum ArrivalModel {
+    ArrivalPoisson,  // 泊松到达，间隔服从指数分布
+    ArrivalBursty    // 成批到达：批次按泊松到达，每批进程数服从几何分布
+};
+
+// 服务时间分布
+enum ServiceModel {
+    ServiceExponential,
+    ServicePareto,   // 重尾分布，alpha越小尾部越长
+    ServiceBimodal   // 短作业与长作业按比例混合，两者各自服从指数分布
+};
+
+// 合成负载参数
+struct GeneratorConfig {
+    size_t count;
+    uint64_t seed;
+    int threads;                  // 0表示按硬件线程数
+
+    ArrivalModel arrival;
+    double arrival_rate;          // 平均每个时间单位到达的进程数
+    double burst_size;            // 成批到达时每批的平均进程数
+
+    ServiceModel service;
+    double service_mean;
+    double pareto_alpha;
+    double long_fraction;         // 双峰分布中长作业的比例
+    double long_mean;             // 双峰分布中长作业的平均服务时间
+
+    std::vector<double> priority_weights;  // 第i项为优先级i+1的权重
+
+    double io_probability;        // 进程带IO的概率
+    double io_mean;               // IO阻塞时间的均值
+    int io_bursts;                // 带IO的进程的IO次数，各次的开始位置在服务期间均匀分布
+
+    GeneratorConfig();
+};
+
+// 按种子确定性地生成进程
+// 进程按固定大小分块，每块的随机数流只由种子和块号决定，
+// 因此多个线程并行生成的结果与线程数无关。生成的进程已按到达时间排列。
+class WorkloadGenerator {
+public:
+    explicit WorkloadGenerator(const GeneratorConfig& config);
+
+    // 生成的进程追加到out，只填写输入字段，进程名留空；第二次及以后的IO追加到bursts。
+    // IO总数超出32位偏移的范围时不追加任何内容，返回false
+    bool Generate(std::vector<ProcessPCB>& out, std::vector<IoBurst>& bursts, std::wstring& error) const;
+
+    // 解析形如"gen:count=100000,seed=7,service=pareto"的负载描述
+    static bool IsSpec(const std::string& spec);
+    static bool ParseSpec(const std::string& spec, GeneratorConfig& config, std::wstring& error);
+
+private:
+    double ChunkDuration(size_t chunk) const;
+    void FillChunk(size_t chunk, double start, ProcessPCB* out, std::vector<IoBurst>& bursts) const;
+    size_t ChunkCount() const;
+
+    GeneratorConfig m_config;
+    std::vector<double> m_priority_cdf;
+};
@@ -0,0 +1,259 @@
+#include "stdafx.h"
+#include "WorkloadLoader.h"
+#include "MappedFile.h"
+#include "Utf8.h"
+#include <climits>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+const int kFieldCount = 6;
+const int kMaxFields = 7;  // 第7列为可选的CPU/IO交替时长
+const size_t kChunkSize = 1 << 20;
+
+// 一个字段在行内的范围
+struct Field {
+    const char* begin;
+    const char* end;
+};
+
+inline bool IsSpace(char c) { return c == ' ' || c == '\r'; }
+inline bool IsSeparator(char c) { return c == ',' || c == '\t'; }
+
+// 解析十进制整数，整个字段（去掉首尾空格）必须是数字
+bool ParseInt(Field f, int& value) {
+    const char* p = f.begin;
+    const char* end = f.end;
+    while (p < end && IsSpace(*p)) p++;
+    while (end > p && IsSpace(end[-1])) end--;
+    if (p == end) return false;
+
+    bool negative = false;
+    if (*p == '-' || *p == '+') {
+        negative = *p == '-';
+        if (++p == end) return false;
+    }
+    long long v = 0;
+    for (; p < end; p++) {
+        if (*p < '0' || *p > '9') return false;
+        v = v * 10 + (*p - '0');
+        if (v > (long long)INT_MAX + 1) return false;
+    }
+    if (negative) v = -v;
+    if (v > INT_MAX || v < INT_MIN) return false;
+    value = (int)v;
+    return true;
+}
+
+// 读取进程名字段，支持双引号
+void ParseName(Field f, wstring& name) {
+    const char* p = f.begin;
+    const char* end = f.end;
+    while (p < end && IsSpace(*p)) p++;
+    while (end > p && IsSpace(end[-1])) end--;
+    if (end - p >= 2 && *p == '"' && end[-1] == '"') {
+        string unquoted;
+        for (const char* q = p + 1; q < end - 1; q++) {
+            if (*q == '"' && q + 1 < end - 1 && q[1] == '"') q++;
+            unquoted.push_back(*q);
+        }
+        DecodeUtf8(unquoted.data(), unquoted.data() + unquoted.size(), name);
+    } else {
+        DecodeUtf8(p, end, name);
+    }
+}
+
+// 按分隔符拆分一行，引号内的分隔符不拆；返回字段数
+int SplitFields(const char* p, const char* end, Field* fields, int max_fields) {
+    int n = 0;
+    bool quoted = false;
+    const char* start = p;
+    for (; p < end; p++) {
+        if (*p == '"') quoted = !quoted;
+        else if (!quoted && IsSeparator(*p)) {
+            if (n < max_fields) fields[n] = Field{ start, p };
+            n++;
+            start = p + 1;
+        }
+    }
+    if (n < max_fields) fields[n] = Field{ start, end };
+    return n + 1;
+}
+
+} // namespace
+
+WorkloadLoader::WorkloadLoader() {
+    Reset();
+}
+
+void WorkloadLoader::Reset() {
+    m_error.clear();
+    m_line = 0;
+    m_seen_data = false;
+    m_sorted = true;
+    m_last_arrive = INT_MIN;
+    m_failed = false;
+}
+
+bool WorkloadLoader::Fail(const wstring& msg) {
+    if (!m_failed) {
+        m_error = msg;
+        m_failed = true;
+    }
+    return false;
+}
+
+// 带行号的错误信息，只在出错时构造
+bool WorkloadLoader::FailLine(const wstring& msg) {
+    return Fail(L"第" + to_wstring(m_line) + L"行：" + msg);
+}
+
+// 读取文件，普通文件用内存映射，映射失败或读标准输入时退回分块读取
+bool WorkloadLoader::LoadFile(const string& path, vector<ProcessPCB>& out, vector<IoBurst>& bursts) {
+    Reset();
+    if (path == "-") return LoadStream(stdin, out, bursts);
+
+    MappedFile mapped;
+    if (mapped.Open(path)) return LoadBuffer(mapped.Data(), mapped.Size(), out, bursts);
+
+    // 管道等无法映射的输入改为分块读取
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) return Fail(L"无法打开文件：" + wstring(path.begin(), path.end()));
+    bool ok = LoadStream(fp, out, bursts);
+    fclose(fp);
+    return ok;
+}
+
+// 分块读取，每块只解析完整的行，剩余的半行移到下一块开头
+bool WorkloadLoader::LoadStream(FILE* fp, vector<ProcessPCB>& out, vector<IoBurst>& bursts) {
+    vector<char> buffer(kChunkSize);
+    size_t kept = 0;
+    while (!m_failed) {
+        if (kept == buffer.size()) buffer.resize(buffer.size() * 2);  // 单行超过缓冲区
+        size_t got = fread(buffer.data() + kept, 1, buffer.size() - kept, fp);
+        bool eof = got == 0;
+        const char* begin = buffer.data();
+        const char* end = begin + kept + got;
+        const char* rest = ParseLines(begin, end, !eof, out, bursts);
+        if (eof) break;
+        kept = end - rest;
+        memmove(buffer.data(), rest, kept);
+    }
+    if (!m_failed && ferror(fp)) Fail(L"读取输入失败");
+    return !m_failed;
+}
+
+bool WorkloadLoader::LoadBuffer(const char* data, size_t size, vector<ProcessPCB>& out, vector<IoBurst>& bursts) {
+    ParseLines(data, data + size, false, out, bursts);
+    return !m_failed;
+}
+
+const char* WorkloadLoader::ParseLines(const char* begin, const char* end, bool partial_tail,
+    vector<ProcessPCB>& out, vector<IoBurst>& bursts) {
+    const char* p = begin;
+    while (p < end && !m_failed) {
+        const char* eol = (const char*)memchr(p, '\n', end - p);
+        if (!eol) {
+            if (partial_tail) return p;
+            eol = end;
+        }
+        m_line++;
+        ParseLine(p, eol, out, bursts);
+        p = eol < end ? eol + 1 : end;
+    }
+    return p;
+}
+
+bool WorkloadLoader::ParseLine(const char* begin, const char* end, vector<ProcessPCB>& out, vector<IoBurst>& bursts) {
+    const char* p = begin;
+    while (p < end && (IsSpace(*p) || *p == '\t')) p++;
+    if (p == end || *p == '#') return true;
+
+    Field fields[kMaxFields];
+    int n = SplitFields(begin, end, fields, kMaxFields);
+    bool counted = n == kFieldCount || n == kMaxFields;
+
+    int values[kFieldCount - 1];
+    bool numeric = counted;
+    for (int i = 1; i < kFieldCount && numeric; i++) {
+        if (!ParseInt(fields[i], values[i - 1])) numeric = false;
+    }
+
+    // 首条非注释行不是数字时视为表头
+    bool first = !m_seen_data;
+    m_seen_data = true;
+    if (!numeric && first && counted) return true;
+    if (!counted)
+        return FailLine(L"应有" + to_wstring(kFieldCount) + L"或" + to_wstring(kMaxFields) + L"个字段，实际" +
+            to_wstring(n) + L"个");
+    if (!numeric) return FailLine(L"时间和优先级必须是整数");
+
+    int arrive_time = values[0], service_time = values[1], priority = values[2];
+    int io_start = values[3], io_time = values[4];
+    if (arrive_time < 0) return FailLine(L"到达时间不能为负数");
+    if (service_time <= 0) return FailLine(L"服务时间必须大于0");
+    if (io_time < 0) return FailLine(L"IO阻塞时间不能为负数");
+    if (arrive_time > INT_MAX - service_time) return FailLine(L"到达时间加服务时间超出int范围");
+    if (io_start < 0) io_time = 0;  // IO开始时间为负表示没有IO
+
+    ProcessPCB pro;
+    ParseName(fields[0], pro.name);
+    pro.arrive_time = arrive_time;
+    pro.service_time = service_time;
+    pro.priority = priority;
+    pro.io_start = io_start;
+    pro.io_time = io_time;
+    pro.burst_offset = pro.burst_count = 0;
+    if (n == kMaxFields && !ParseBursts(fields[kMaxFields - 1].begin, fields[kMaxFields - 1].end, pro, bursts))
+        return false;
+    out.push_back(std::move(pro));
+
+    if (arrive_time < m_last_arrive) m_sorted = false;
+    m_last_arrive = arrive_time;
+    return true;
+}
+
+// 解析第7列的CPU/IO交替时长，改写进程的IO字段；第一次IO放在PCB中，其余追加到bursts。空字段表示不使用该列
+// 出错时bursts恢复到本行开始前的长度，不留下半行的IO
+bool WorkloadLoader::ParseBursts(const char* begin, const char* end, ProcessPCB& pro, vector<IoBurst>& bursts) {
+    while (begin < end && IsSpace(*begin)) begin++;
+    while (end > begin && IsSpace(end[-1])) end--;
+    if (begin == end) return true;
+
+    size_t first = bursts.size();
+    auto fail = [&](const wchar_t* message) {
+        bursts.resize(first);
+        return FailLine(message);
+    };
+    long long cpu = 0;  // 已列出的CPU时长之和，即下一次IO开始时的累计运行时间
+    int index = 0, value = 0;
+    pro.io_start = -1;
+    pro.io_time = 0;
+    for (const char* p = begin; p <= end; index++) {
+        const char* colon = (const char*)memchr(p, ':', end - p);
+        if (!colon) colon = end;
+        if (!ParseInt(Field{ p, colon }, value)) return fail(L"CPU/IO时长列应为冒号分隔的整数");
+        p = colon + 1;
+        if (index % 2 == 0) {
+            if (value < 0) return fail(L"CPU时长不能为负数");
+            cpu += value;
+            if (cpu > INT_MAX) return fail(L"CPU时长之和超出int范围");
+        } else if (value <= 0) {
+            return fail(L"IO时长必须大于0");
+        } else if (pro.io_time == 0) {
+            pro.io_start = (int)cpu;
+            pro.io_time = value;
+        } else {
+            bursts.push_back(IoBurst{ (int32_t)cpu, value });
+        }
+    }
+    if (index % 2 == 0) return fail(L"CPU/IO时长列应以CPU时长结尾");
+    if (value <= 0) return fail(L"最后一段CPU时长必须大于0");
+    if (cpu != pro.service_time) return fail(L"CPU时长之和应等于服务时间");
+    if (bursts.size() > UINT32_MAX) return fail(L"IO总次数超出范围");
+    pro.burst_offset = (uint32_t)first;
+    pro.burst_count = (uint32_t)(bursts.size() - first);
+    return true;
+}
@@ -0,0 +1,54 @@
+// WorkloadLoader.h
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include "ProcessSchedulingSimulator.h"
+
+// 批量负载读取：从CSV/TSV文件或标准输入读取进程
+// 每行一个进程：进程名,到达时间,服务时间,优先级,IO开始时间,IO阻塞时间
+// IO开始时间为负数表示没有IO。逗号和制表符均可作分隔符；空行和以#开头的行忽略，首行不是数字时视为表头。
+// 进程名可用双引号括起（内部的""表示一个引号），按UTF-8解码。
+// 可选的第7列是冒号分隔的CPU/IO交替时长"CPU:IO:CPU:...:CPU"，用于有多次IO的进程：
+// 各CPU时长之和必须等于服务时间，最后一段CPU至少为1，IO时长至少为1；有该列时IO开始时间和IO阻塞时间两列不使用。
+// 读取的进程追加到调用方的数组中，只填写上述输入字段，第二次及以后的IO追加到bursts。
+class WorkloadLoader {
+public:
+    WorkloadLoader();
+
+    // 读取文件，path为"-"时读标准输入；普通文件优先用内存映射
+    bool LoadFile(const std::string& path, std::vector<ProcessPCB>& out, std::vector<IoBurst>& bursts);
+
+    // 从已打开的文件分块流式读取
+    bool LoadStream(FILE* fp, std::vector<ProcessPCB>& out, std::vector<IoBurst>& bursts);
+
+    // 解析内存中的整段文本
+    bool LoadBuffer(const char* data, size_t size, std::vector<ProcessPCB>& out, std::vector<IoBurst>& bursts);
+
+    // 清除出错状态，保留行号和表头状态，以便逐行读取时跳过错误行继续
+    void ClearError() { m_error.clear(); m_failed = false; }
+
+    // 出错时的说明（含行号）
+    const std::wstring& Error() const { return m_error; }
+
+    // 读入的进程是否已按到达时间非递减排列（是则无需再排序）
+    bool IsSorted() const { return m_sorted; }
+
+private:
+    void Reset();
+    // 解析[begin, end)中的完整行，partial_tail为真时最后一行可能不完整，返回未处理部分的起点
+    const char* ParseLines(const char* begin, const char* end, bool partial_tail, std::vector<ProcessPCB>& out,
+        std::vector<IoBurst>& bursts);
+    bool ParseLine(const char* begin, const char* end, std::vector<ProcessPCB>& out, std::vector<IoBurst>& bursts);
+    bool Fail(const std::wstring& msg);
+    bool FailLine(const std::wstring& msg);
+    bool ParseBursts(const char* begin, const char* end, ProcessPCB& pro, std::vector<IoBurst>& bursts);
+
+    std::wstring m_error;
+    long long m_line;        // 当前行号（从1开始）
+    bool m_seen_data;        // 是否已读到第一条非注释行
+    bool m_sorted;
+    int m_last_arrive;
+    bool m_failed;
+};
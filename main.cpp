@@ -0,0 +1,483 @@
+#define UNICODE
+#define _UNICODE
+#include "stdafx.h"
+#include "ProcessSchedulingSimulator.h"
+#include "BinaryFormat.h"
+#include "EventLog.h"
+#include "OnlineScheduler.h"
+#include "GanttRender.h"
+#include "PolicyComparison.h"
+#include "QuantumTuner.h"
+#include "Replication.h"
+#include "Snapshot.h"
+#include "WorkloadGenerator.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <vector>
+#include <clocale>
+#include <climits>
+#include <thread>
+#ifdef _WIN32
+#include "GanttChart.h"
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+using namespace std;
+
+// 用法：ProcessSchedulingSimulator [CPU选项] [负载文件|-] [算法编号] [结果文件]
+//       未指定负载文件或算法编号时交互输入；模拟结束后在Windows下显示甘特图窗口
+//       CPU选项：--cpus N（CPU数）、--per-cpu（每个CPU一个就绪队列）、
+//                --balance T（每隔T个时间单位均衡各队列）、--steal（空闲CPU从其他队列取进程）、
+//                --quantum Q（时间片轮转的时间片长度，默认2）、
+//                --mlfq-quanta 2,4,8（多级反馈队列各级的时间片，级数即逗号分隔的个数，最多64级）、
+//                --mlfq-boost T（多级反馈队列每隔T个时间单位把所有进程提升到最高级，0不提升，默认50）、
+//                --cfs-latency L（CFS目标延迟，默认16）、--cfs-granularity G（CFS最小粒度，默认2）、
+//                --trace 事件文件（调度事件写入二进制事件日志，不再输出调度日志）、
+//                --trace-level L（0不记录，1只记完成，2调度日志（默认），3另记到达和IO完成）、
+//                --headless（不交互、不显示窗口，必须给出负载文件和算法编号，用于批量模拟）、
+//                --gantt 图片文件（模拟或读取结果后把甘特图保存为.svg或.png）、
+//                --gantt-width W（图片宽度，默认1200）、--gantt-lanes cpu|process（每个CPU或每个进程一条泳道）、
+//                --cache 目录（同一负载和算法参数模拟过时直接取缓存的结果）、--cache-size MB（缓存容量，默认256）、
+//                --tick-ns N（在线模式中一个时间单位对应的纳秒数，默认1000，0为不与墙上时间同步）
+//       ProcessSchedulingSimulator --convert 输入负载 输出负载   文本与二进制负载互转
+//       ProcessSchedulingSimulator --results 结果文件            显示保存的模拟结果
+//       ProcessSchedulingSimulator [--trace-level L] --events 事件文件 [text|jsonl]
+//                                  把事件日志导出为调度日志文本或JSONL
+//       ProcessSchedulingSimulator [CPU选项] --compare 负载文件 [算法列表]
+//                                  负载只读取一次，在多个线程上同时模拟各算法（默认全部，如1,2,5），输出比较表
+//       ProcessSchedulingSimulator [CPU选项] --what-if 负载文件 时刻 前段算法 [算法列表]
+//                                  用前段算法模拟到指定时刻后取快照，各算法从快照分叉并行接着模拟，输出比较表
+//       ProcessSchedulingSimulator [CPU选项] --replicate 负载描述 重复次数 [算法列表]
+//                                  按"gen:"负载描述以不同种子重复模拟，输出各指标的均值、标准差和95%置信区间
+//       ProcessSchedulingSimulator [CPU选项] --tune-quantum 负载文件 [最大时间片]
+//                                  搜索时间片轮转的时间片长度，输出响应时间、周转时间和上下文切换次数的帕累托前沿
+//       ProcessSchedulingSimulator [CPU选项] --online 来源 算法 [每秒到达数] [生产者线程数]
+//                                  在线调度：来源为"gen:"负载描述（由生产者线程按到达速率提交）、-（从标准输入逐行读取）
+//                                  或unix:路径（在Unix域套接字上接受连接），每秒输出运行状态和决策延迟
+
+// 解析逗号分隔的算法编号
+static bool ParsePolicies(const char* list, vector<int>& out) {
+    out.clear();
+    for (const char* p = list; *p; ) {
+        char* end;
+        long n = strtol(p, &end, 10);
+        if (end == p || n < 1 || n > kLastPolicy) return false;
+        if (*end && *end != ',') return false;
+        out.push_back((int)n);
+        p = *end ? end + 1 : end;
+    }
+    return !out.empty();
+}
+
+// 解析逗号分隔的MLFQ各级时间片
+static bool ParseQuanta(const char* list, vector<int>& out) {
+    out.clear();
+    for (const char* p = list; *p; ) {
+        char* end;
+        long n = strtol(p, &end, 10);
+        if (end == p || n < 1 || n > INT_MAX) return false;
+        if (*end && *end != ',') return false;
+        out.push_back((int)n);
+        p = *end ? end + 1 : end;
+    }
+    return !out.empty() && out.size() <= (size_t)MlfqIndex::kMaxLevels;
+}
+
+// 全部算法编号
+static vector<int> AllPolicies() {
+    vector<int> policies;
+    for (int p = PolicyFCFS; p <= kLastPolicy; p++) policies.push_back(p);
+    return policies;
+}
+
+// 比较模式：读取负载后并行运行各算法，只输出比较表
+static int Compare(ProcessScheduler& workload, int argc, char* argv[]) {
+    vector<int> policies = AllPolicies();
+    if (argc < 3 || (argc > 3 && !ParsePolicies(argv[3], policies))) {
+        wcout << L"用法：--compare 负载文件 [算法编号列表，如1,2,5]\n";
+        return EXIT_FAILURE;
+    }
+    if (!workload.LoadWorkload(argv[2])) return EXIT_FAILURE;
+    wstring error;
+    if (!workload.CheckTimeRange(error)) {
+        wcout << error << L"\n";
+        return EXIT_FAILURE;
+    }
+    vector<PolicyOutcome> outcomes;
+    PolicyComparison(workload).Run(policies, 0, outcomes);
+    PolicyComparison::PrintTable(outcomes);
+    return EXIT_SUCCESS;
+}
+
+// 假设分析模式：前段只模拟一次，快照之后的部分由各算法在各自的线程中分别模拟
+static int WhatIf(ProcessScheduler& workload, int argc, char* argv[]) {
+    vector<int> policies = AllPolicies();
+    long time = argc > 3 ? strtol(argv[3], nullptr, 10) : -1;
+    int base = argc > 4 ? atoi(argv[4]) : 0;
+    if (argc < 5 || time < 0 || base < 1 || base > kLastPolicy || (argc > 5 && !ParsePolicies(argv[5], policies))) {
+        wcout << L"用法：--what-if 负载文件 时刻 前段算法编号 [接手的算法编号列表，如1,2,5]\n";
+        return EXIT_FAILURE;
+    }
+    if (!workload.LoadWorkload(argv[2])) return EXIT_FAILURE;
+    wstring error;
+    if (!workload.CheckTimeRange(error)) {
+        wcout << error << L"\n";
+        return EXIT_FAILURE;
+    }
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    workload.quiet = true;
+    workload.Start((SchedulePolicy)base);
+    workload.RunUntil(time);
+    SimulationSnapshot snapshot(std::move(workload));
+    wcout << PolicyTitle(base) << L"模拟到时刻" << snapshot.Time() << L"，已完成" << snapshot.State().finish_queue.size()
+        << L"个进程，前段用时" << chrono::duration<double>(chrono::steady_clock::now() - start).count() << L"秒\n";
+
+    // 各分支沿用命令行给出的算法参数（已随状态移交给快照）
+    vector<SnapshotBranch> branches;
+    for (int policy : policies) branches.push_back(SnapshotBranch{ (SchedulePolicy)policy, &snapshot.State() });
+    vector<PolicyOutcome> outcomes;
+    snapshot.RunBranches(branches, 0, outcomes);
+    PolicyComparison::PrintTable(outcomes);
+    return EXIT_SUCCESS;
+}
+
+// 重复实验模式：负载描述中的seed作为基准种子
+static int Replicate(const ProcessScheduler& settings, int argc, char* argv[]) {
+    vector<int> policies = AllPolicies();
+    long replications = argc > 3 ? strtol(argv[3], nullptr, 10) : 0;
+    if (argc < 4 || replications < 1 || (argc > 4 && !ParsePolicies(argv[4], policies))) {
+        wcout << L"用法：--replicate gen:负载描述 重复次数 [算法编号列表，如1,2,5]\n";
+        return EXIT_FAILURE;
+    }
+    GeneratorConfig config;
+    wstring error;
+    if (!WorkloadGenerator::ParseSpec(argv[2], config, error)) {
+        wcout << L"负载描述无效：" << error << L"\n";
+        return EXIT_FAILURE;
+    }
+    vector<ReplicationSummary> summaries;
+    size_t skipped = ReplicationRunner(config, settings).Run((size_t)replications, policies, 0, summaries);
+    if (skipped) wcout << skipped << L"次重复的负载总时长超出int范围，已跳过\n";
+    ReplicationRunner::PrintSummary(summaries);
+    return EXIT_SUCCESS;
+}
+
+// 时间片搜索模式
+static int TuneQuantum(ProcessScheduler& workload, int argc, char* argv[]) {
+    int max_quantum = argc > 3 ? atoi(argv[3]) : 0;
+    if (argc < 3 || max_quantum < 0) {
+        wcout << L"用法：--tune-quantum 负载文件 [最大时间片]\n";
+        return EXIT_FAILURE;
+    }
+    if (!workload.LoadWorkload(argv[2])) return EXIT_FAILURE;
+    wstring error;
+    if (!workload.CheckTimeRange(error)) {
+        wcout << error << L"\n";
+        return EXIT_FAILURE;
+    }
+    QuantumTuner tuner(workload);
+    tuner.Tune(max_quantum, 0);
+    wcout << L"共模拟" << tuner.Results().size() << L"个时间片\n";
+    QuantumTuner::PrintFrontier(tuner.Frontier());
+    return EXIT_SUCCESS;
+}
+
+// 在线模式的一行运行状态
+static void PrintOnlineStatus(const OnlineStatus& status) {
+    wcout << L"[" << status.wall_seconds << L"秒] 时刻" << status.sim_time << L" 到达" << status.arrivals
+        << L" 完成" << status.finished << L" 就绪" << status.ready << L" 运行" << status.running
+        << L" 决策延迟p50/p99 " << status.latency_p50 << L"/" << status.latency_p99 << L"微秒"
+        << L" 平均周转" << status.stats.avg_turnaround;
+    if (status.rejected) wcout << L" 拒绝" << status.rejected;
+    wcout << L"\n";
+}
+
+// 在线模式：生产者线程提交进程，引擎在本线程按墙上时间推进
+static int Online(ProcessScheduler& scheduler, long long tick_ns, int argc, char* argv[]) {
+    string source = argc > 2 ? argv[2] : "";
+    int policy = argc > 3 ? atoi(argv[3]) : 0;
+    double rate = argc > 4 ? atof(argv[4]) : 0;
+    int producers = argc > 5 ? atoi(argv[5]) : 1;
+    if (argc < 4 || policy < 1 || policy > kLastPolicy || rate < 0 || producers < 1 || producers > 256) {
+        wcout << L"用法：--online gen:负载描述|-|unix:路径 算法编号 [每秒到达数，0不限速] [生产者线程数]\n";
+        return EXIT_FAILURE;
+    }
+    wstring error;
+    vector<ProcessPCB> generated;
+    vector<IoBurst> bursts;
+    if (WorkloadGenerator::IsSpec(source)) {
+        GeneratorConfig config;
+        if (!WorkloadGenerator::ParseSpec(source, config, error)) {
+            wcout << L"负载描述无效：" << error << L"\n";
+            return EXIT_FAILURE;
+        }
+        if (!WorkloadGenerator(config).Generate(generated, bursts, error)) {
+            wcout << L"负载描述无效：" << error << L"\n";
+            return EXIT_FAILURE;
+        }
+    } else if (source != "-" && source.compare(0, 5, "unix:") != 0) {
+        wcout << L"来源应为gen:负载描述、-或unix:路径\n";
+        return EXIT_FAILURE;
+    }
+
+    EventLog log(scheduler.trace_level);
+    if (!scheduler.trace_path.empty()) {
+        if (!log.Start(policy, scheduler.cpu_count, scheduler.trace_path, error)) {
+            wcout << error << L"\n";
+            return EXIT_FAILURE;
+        }
+        scheduler.event_log = &log;
+    }
+    scheduler.quiet = true;
+    OnlineScheduler online(scheduler, (SchedulePolicy)policy, tick_ns);
+    online.Reserve(generated.size());
+
+    // 生产者在引擎开始前登记，引擎在它们都注销且进程全部完成后返回
+    vector<thread> threads;
+    bool served = true;
+    if (!generated.empty()) {
+        for (int i = 0; i < producers; i++) {
+            online.AddProducer();
+            threads.emplace_back([&, i]() {
+                ProduceGenerated(online, generated, bursts, (size_t)i, (size_t)producers, rate);
+                online.RemoveProducer();
+            });
+        }
+    } else if (source == "-") {
+        online.AddProducer();
+        threads.emplace_back([&]() {
+            ProduceStream(online, stdin);
+            online.RemoveProducer();
+        });
+    } else if (source.compare(0, 5, "unix:") == 0) {
+        online.AddProducer();
+        threads.emplace_back([&]() {
+            served = ServeUnixSocket(online, source.substr(5), error);
+            online.RemoveProducer();
+        });
+    }
+    wcout << PolicyTitle(policy) << L"在线调度开始\n";
+    online.Run(PrintOnlineStatus, 1.0);
+    for (thread& producer : threads) producer.join();
+    scheduler.event_log = nullptr;
+    log.Stop();
+    if (!served) {
+        wcout << error << L"\n";
+        return EXIT_FAILURE;
+    }
+
+    const HdrHistogram& latency = online.Latency();
+    ScheduleStatistics stats = scheduler.ComputeStatistics();
+    wcout << L"共接收" << scheduler.pcb_pool.size() << L"个进程，完成" << stats.finished;
+    if (online.Invalid()) wcout << L"，" << online.Invalid() << L"行无效";
+    wcout << L"\n平均等待" << stats.avg_wait << L"，平均周转" << stats.avg_turnaround << L"，平均带权周转"
+        << stats.avg_weighted << L"，平均响应" << stats.avg_response << L"\n";
+    wcout << L"决策延迟（微秒）p50 " << latency.ValueAtQuantile(0.5) / 1e3 << L"，p99 "
+        << latency.ValueAtQuantile(0.99) / 1e3 << L"，p99.9 " << latency.ValueAtQuantile(0.999) / 1e3
+        << L"，最大 " << latency.ValueAtQuantile(1.0) / 1e3 << L"\n";
+    return EXIT_SUCCESS;
+}
+
+// 导出事件日志，日志中没有进程名，文本中以P加ID代替
+static int ExportEvents(EventLevel level, int argc, char* argv[]) {
+    string format = argc > 3 ? argv[3] : "text";
+    if (argc < 3 || (format != "text" && format != "jsonl")) {
+        wcout << L"用法：--events 事件文件 [text|jsonl]\n";
+        return EXIT_FAILURE;
+    }
+    EventLogReader reader;
+    if (!reader.Open(argv[2])) {
+        wcout << reader.Error() << L"\n";
+        return EXIT_FAILURE;
+    }
+    if (format == "text")
+        ExportEventsText(reader.Header(), reader.Records(), reader.Count(), level, nullptr, wcout);
+    else
+        ExportEventsJsonl(reader.Header(), reader.Records(), reader.Count(), level, wcout);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[]) {
+#ifdef _WIN32
+    // 设置控制台为UTF-8模式
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+    _setmode(_fileno(stdout), _O_U16TEXT);
+#else
+    // 宽字符输出按UTF-8编码
+    if (!setlocale(LC_ALL, "C.UTF-8")) setlocale(LC_ALL, "");
+#endif
+
+    // CPU选项可出现在其他参数之前
+    int cpus = 1, balance = 0, quantum = 2, mlfq_boost = 50, trace_level = EventLevelSchedule;
+    int cfs_latency = 16, cfs_granularity = 2;
+    vector<int> mlfq_quanta = { 2, 4, 8 };
+    bool per_cpu = false, steal = false, headless = false;
+    string trace_path, gantt_path, cache_path;
+    long long cache_mb = 256, tick_ns = 1000;
+    GanttOptions gantt;
+    int first = 1;
+    for (; first < argc; first++) {
+        string option = argv[first];
+        if (option == "--cpus" && first + 1 < argc) {
+            cpus = atoi(argv[++first]);
+        } else if (option == "--quantum" && first + 1 < argc) {
+            quantum = atoi(argv[++first]);
+        } else if (option == "--mlfq-quanta" && first + 1 < argc) {
+            if (!ParseQuanta(argv[++first], mlfq_quanta)) {
+                wcout << L"--mlfq-quanta 应为1到64个逗号分隔的正整数，如2,4,8\n";
+                return EXIT_FAILURE;
+            }
+        } else if (option == "--mlfq-boost" && first + 1 < argc) {
+            mlfq_boost = atoi(argv[++first]);
+        } else if (option == "--cfs-latency" && first + 1 < argc) {
+            cfs_latency = atoi(argv[++first]);
+        } else if (option == "--cfs-granularity" && first + 1 < argc) {
+            cfs_granularity = atoi(argv[++first]);
+        } else if (option == "--trace" && first + 1 < argc) {
+            trace_path = argv[++first];
+        } else if (option == "--trace-level" && first + 1 < argc) {
+            trace_level = atoi(argv[++first]);
+        } else if (option == "--balance" && first + 1 < argc) {
+            balance = atoi(argv[++first]);
+        } else if (option == "--per-cpu") {
+            per_cpu = true;
+        } else if (option == "--steal") {
+            steal = true;
+        } else if (option == "--headless") {
+            headless = true;
+        } else if (option == "--cache" && first + 1 < argc) {
+            cache_path = argv[++first];
+        } else if (option == "--cache-size" && first + 1 < argc) {
+            cache_mb = atoll(argv[++first]);
+        } else if (option == "--tick-ns" && first + 1 < argc) {
+            tick_ns = atoll(argv[++first]);
+        } else if (option == "--gantt" && first + 1 < argc) {
+            gantt_path = argv[++first];
+        } else if (option == "--gantt-width" && first + 1 < argc) {
+            gantt.width = atoi(argv[++first]);
+        } else if (option == "--gantt-lanes" && first + 1 < argc) {
+            string lanes = argv[++first];
+            if (lanes != "cpu" && lanes != "process") {
+                wcout << L"--gantt-lanes 应为cpu或process\n";
+                return EXIT_FAILURE;
+            }
+            gantt.per_process = lanes == "process";
+        } else {
+            break;
+        }
+    }
+    if (cpus < 1 || cpus > kMaxCpus || balance < 0) {
+        wcout << L"CPU数应在1到" << kMaxCpus << L"之间，均衡间隔不能为负\n";
+        return EXIT_FAILURE;
+    }
+    if (quantum < 1) {
+        wcout << L"时间片长度至少为1\n";
+        return EXIT_FAILURE;
+    }
+    if (mlfq_boost < 0) {
+        wcout << L"提升间隔不能为负\n";
+        return EXIT_FAILURE;
+    }
+    if (cfs_granularity < 1 || cfs_latency < cfs_granularity) {
+        wcout << L"CFS最小粒度至少为1，目标延迟不能小于最小粒度\n";
+        return EXIT_FAILURE;
+    }
+    if (gantt.width < 200 || gantt.width > 100000) {
+        wcout << L"甘特图宽度应在200到100000之间\n";
+        return EXIT_FAILURE;
+    }
+    if (cache_mb < 1 || cache_mb > (1LL << 30)) {
+        wcout << L"缓存容量应在1MB到1PB之间\n";
+        return EXIT_FAILURE;
+    }
+    if (tick_ns < 0) {
+        wcout << L"--tick-ns 不能为负\n";
+        return EXIT_FAILURE;
+    }
+    if (trace_level < EventLevelOff || trace_level > EventLevelTrace) {
+        wcout << L"事件级别应在0到3之间\n";
+        return EXIT_FAILURE;
+    }
+    argc -= first - 1;
+    argv += first - 1;
+
+    string command = argc > 1 ? argv[1] : "";
+    // 导出的JSONL可能交给其他程序处理，不输出标题
+    if (command == "--events") return ExportEvents((EventLevel)trace_level, argc, argv);
+
+    wcout << L"===================================================\n";
+    wcout << L"          操作系统进程调度模拟实验        \n";
+    wcout << L"===================================================\n\n";
+
+    if (command == "--convert") {
+        if (argc < 4) {
+            wcout << L"用法：--convert 输入负载 输出负载\n";
+            return EXIT_FAILURE;
+        }
+        wstring error;
+        if (!ConvertWorkload(argv[2], argv[3], error)) {
+            wcout << L"转换失败：" << error << L"\n";
+            return EXIT_FAILURE;
+        }
+        wcout << L"转换完成\n";
+        return EXIT_SUCCESS;
+    }
+
+    ProcessScheduler scheduler;
+    scheduler.ConfigureCpus(cpus, per_cpu, balance, steal);
+    scheduler.time_quantum = quantum;
+    scheduler.mlfq_quanta = mlfq_quanta;
+    scheduler.mlfq_boost = mlfq_boost;
+    scheduler.cfs_latency = cfs_latency;
+    scheduler.cfs_min_granularity = cfs_granularity;
+    scheduler.trace_level = (EventLevel)trace_level;
+    scheduler.trace_path = trace_path;
+    scheduler.cache_path = cache_path;
+    scheduler.cache_limit = (uint64_t)cache_mb << 20;
+    if (command == "--compare") return Compare(scheduler, argc, argv);
+    if (command == "--what-if") return WhatIf(scheduler, argc, argv);
+    if (command == "--replicate") return Replicate(scheduler, argc, argv);
+    if (command == "--tune-quantum") return TuneQuantum(scheduler, argc, argv);
+    if (command == "--online") return Online(scheduler, tick_ns, argc, argv);
+    bool done;
+    if (command == "--results") {
+        if (argc < 3) {
+            wcout << L"用法：--results 结果文件\n";
+            return EXIT_FAILURE;
+        }
+        done = scheduler.ShowResults(argv[2]);
+    } else {
+        int policy = argc > 2 ? atoi(argv[2]) : 0;
+        if (headless && (command.empty() || policy < 1 || policy > kLastPolicy)) {
+            wcout << L"--headless 需要负载文件和算法编号（1-8）\n";
+            return EXIT_FAILURE;
+        }
+        done = scheduler.Run(command, policy, argc > 3 ? argv[3] : "");
+    }
+    if (!done) return EXIT_FAILURE;
+    if (!gantt_path.empty()) {
+        GanttRenderer renderer(scheduler.timelines, scheduler.pcb_pool);
+        wstring error;
+        if (!WriteGantt(renderer.Layout(gantt), gantt_path, error)) {
+            wcout << error << L"\n";
+            return EXIT_FAILURE;
+        }
+        wcout << L"甘特图已保存\n";
+    }
+
+#ifdef _WIN32
+    if (!headless) {
+        wcout << L"\n模拟结束，甘特图将在窗口中显示。\n";
+        GanttChart chart;
+        chart.Show(scheduler.timelines, scheduler.pcb_pool);
+        return EXIT_SUCCESS;
+    }
+#endif
+    wcout << L"\n模拟结束。\n";
+    return EXIT_SUCCESS;
+}
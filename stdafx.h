@@ -1,9 +1,5 @@
 #pragma once
 
-#include <windows.h>
-#include <tchar.h>
-#include <strsafe.h>
-#include <gdiplus.h>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -0,0 +1,350 @@
+// EngineTest.cpp
+// 事件驱动调度核心与逐时钟实现的等价性测试
+// 参考实现以基线（daa4e59）中各算法逐时钟推进的循环为基础（每个时钟单位处理一轮，阻塞后同一时刻再处理一轮），
+// 在随机的小负载上逐个算法比较完成顺序、各进程的时间字段和甘特图。与基线有意不同之处：
+// 1. 甘特图项在IO检查之后记录：基线在进程阻塞的那一轮也记录一项，而该时钟单位进程并未执行，
+//    同一时刻接着运行的进程还会再记一项；引擎的甘特图只记录实际执行的时钟单位。
+// 2. 就绪队列用stable_sort并写明键值相同时的次序（动态优先级按到达时间，其余按入队先后）：
+//    基线的std::sort不稳定，键值相同时的次序取决于标准库实现，无法作为比较的依据。
+// 3. HRRN按精确的响应比排序，不再按放大10000倍取整后的值，也不改写优先级：
+//    取整会让相近的响应比相等，改写优先级会让结果表中的优先级失去原意。
+// 基线中没有的部分按同样的逐时钟方式写出：
+// MLFQ每个时钟按级别稳定排序就绪队列，提升时把所有进程（包括运行和阻塞的）改为0级。
+// CFS每个时钟按虚拟运行时间稳定排序，放置进程时逐个扫描就绪队列求最小值。
+// 随机负载中带IO的进程有一到三次IO，参考实现每个进程自带IO列表，一次IO结束时换上下一次，引擎从burst_arena取出后续IO。
+#include "../ProcessSchedulingSimulator.h"
+#include "../Cfs.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct RefProcess {
+    int ID;
+    int arrive_time, service_time, priority;
+    int io_start, io_time, all_time, cpu_time;
+    int start_time, end_time, wait_time, response_time, turnaround_time;
+    int level;
+    long long vruntime;
+    vector<IoBurst> more_io;  // 第二次及以后的IO
+    size_t next_io;
+};
+
+// 时间片和MLFQ的配置
+struct RefConfig {
+    int time_quantum;
+    vector<int> mlfq_quanta;
+    int mlfq_boost;
+    int cfs_latency, cfs_min_granularity;
+};
+
+struct RefResult {
+    vector<RefProcess> finished;
+    vector<pair<int, int>> gantt;  // (进程ID, 时刻)，每个执行的时钟单位一项
+};
+
+// 逐时钟参考实现
+RefResult RunReference(vector<RefProcess> arrive_queue, SchedulePolicy policy, const RefConfig& config) {
+    const int time_quantum = config.time_quantum;
+    const int levels = (int)config.mlfq_quanta.size();
+    int next_boost = 0;
+    long long min_vruntime = 0;
+    int slice = 0;
+    RefResult result;
+    vector<RefProcess> ready_queue, blocked_queue;
+    RefProcess running = RefProcess();
+    bool has_running = false;
+    bool need_schedule = true;
+    int time_slice = 0;
+    int current_time = 0;
+
+    stable_sort(arrive_queue.begin(), arrive_queue.end(),
+        [](const RefProcess& a, const RefProcess& b) { return a.arrive_time < b.arrive_time; });
+
+    // CFS：就绪队列和运行进程中最小的虚拟运行时间，不回退
+    auto update_min_vruntime = [&]() {
+        long long lowest = LLONG_MAX;
+        for (const RefProcess& pro : ready_queue) lowest = min(lowest, pro.vruntime);
+        if (has_running) lowest = min(lowest, running.vruntime);
+        if (lowest != LLONG_MAX) min_vruntime = max(min_vruntime, lowest);
+    };
+
+    while (true) {
+        if (!has_running && arrive_queue.empty() && ready_queue.empty() && blocked_queue.empty()) break;
+
+        while (!arrive_queue.empty() && arrive_queue.front().arrive_time <= current_time) {
+            if (policy == PolicyCFS) {
+                update_min_vruntime();
+                arrive_queue.front().vruntime = min_vruntime;
+            }
+            ready_queue.push_back(arrive_queue.front());
+            arrive_queue.erase(arrive_queue.begin());
+        }
+        for (auto it = blocked_queue.begin(); it != blocked_queue.end(); ) {
+            if (--it->io_time <= 0) {
+                if (it->next_io < it->more_io.size()) {
+                    it->io_start = it->more_io[it->next_io].start;
+                    it->io_time = it->more_io[it->next_io].time;
+                    it->next_io++;
+                }
+                if (policy == PolicyMLFQ) it->level = max(0, it->level - 1);
+                if (policy == PolicyCFS) {
+                    update_min_vruntime();
+                    it->vruntime = max(it->vruntime, min_vruntime - ((long long)config.cfs_latency << kCfsShift) / 2);
+                }
+                ready_queue.push_back(*it);
+                it = blocked_queue.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        switch (policy) {
+        case PolicyDynamicPriority:
+            stable_sort(ready_queue.begin(), ready_queue.end(), [](const RefProcess& a, const RefProcess& b) {
+                if (a.priority != b.priority) return a.priority > b.priority;
+                return a.arrive_time < b.arrive_time;
+            });
+            break;
+        case PolicySJF:
+        case PolicySRTF:
+            stable_sort(ready_queue.begin(), ready_queue.end(),
+                [](const RefProcess& a, const RefProcess& b) { return a.all_time < b.all_time; });
+            break;
+        case PolicyHRRN:
+            // 按精确的响应比排序
+            stable_sort(ready_queue.begin(), ready_queue.end(), [](const RefProcess& a, const RefProcess& b) {
+                return (long long)a.wait_time * b.service_time > (long long)b.wait_time * a.service_time;
+            });
+            break;
+        case PolicyMLFQ:
+            stable_sort(ready_queue.begin(), ready_queue.end(),
+                [](const RefProcess& a, const RefProcess& b) { return a.level < b.level; });
+            if (config.mlfq_boost > 0 && current_time >= next_boost) {
+                for (RefProcess& pro : ready_queue) pro.level = 0;
+                for (RefProcess& pro : blocked_queue) pro.level = 0;
+                running.level = 0;
+                time_slice = 0;
+                next_boost = (current_time / config.mlfq_boost + 1) * config.mlfq_boost;
+            }
+            break;
+        case PolicyCFS:
+            stable_sort(ready_queue.begin(), ready_queue.end(),
+                [](const RefProcess& a, const RefProcess& b) { return a.vruntime < b.vruntime; });
+            break;
+        default:
+            break;
+        }
+
+        for (RefProcess& pro : ready_queue) pro.wait_time++;
+
+        bool dispatch = false;
+        if (policy == PolicySRTF) {
+            if (!ready_queue.empty() && (!has_running || ready_queue[0].all_time < running.all_time)) {
+                if (has_running) ready_queue.push_back(running);
+                dispatch = true;
+            }
+        } else if (policy == PolicyMLFQ) {
+            if (!ready_queue.empty() && (!has_running || ready_queue[0].level < running.level)) {
+                if (has_running) ready_queue.push_back(running);
+                dispatch = true;
+            }
+        } else if (policy == PolicyCFS) {
+            long long granularity = (long long)config.cfs_min_granularity << kCfsShift;
+            if (!ready_queue.empty() && (!has_running || ready_queue[0].vruntime + granularity < running.vruntime)) {
+                if (has_running) ready_queue.push_back(running);
+                dispatch = true;
+            }
+        } else {
+            dispatch = need_schedule && !ready_queue.empty();
+        }
+        if (dispatch) {
+            running = ready_queue[0];
+            ready_queue.erase(ready_queue.begin());
+            has_running = true;
+            if (running.start_time == -1) running.start_time = current_time;
+            if (running.response_time == -1) running.response_time = current_time - running.arrive_time;
+            time_slice = 0;
+            need_schedule = false;
+            if (policy == PolicyCFS) {
+                // 调度周期按可运行进程数延长，按权重分配，不少于最小粒度
+                long long load = CfsWeight(running.priority), count = (long long)ready_queue.size() + 1;
+                for (const RefProcess& pro : ready_queue) load += CfsWeight(pro.priority);
+                long long period = max<long long>(config.cfs_latency, count * config.cfs_min_granularity);
+                slice = (int)max<long long>(config.cfs_min_granularity, period * CfsWeight(running.priority) / load);
+            }
+        }
+
+        if (has_running) {
+            if (running.cpu_time == running.io_start && running.io_time > 0) {
+                blocked_queue.push_back(running);
+                has_running = false;
+                need_schedule = true;
+                continue;
+            }
+
+            result.gantt.push_back(make_pair(running.ID, current_time));
+            running.cpu_time++;
+            running.all_time--;
+            time_slice++;
+            running.vruntime += CfsVruntimeStep(running.priority);
+
+            if (running.all_time == 0) {
+                running.end_time = current_time + 1;
+                running.turnaround_time = running.end_time - running.arrive_time;
+                result.finished.push_back(running);
+                has_running = false;
+                need_schedule = true;
+            } else if (policy == PolicyRoundRobin && time_slice == time_quantum) {
+                ready_queue.push_back(running);
+                has_running = false;
+                need_schedule = true;
+            } else if (policy == PolicyCFS && time_slice == slice) {
+                ready_queue.push_back(running);
+                has_running = false;
+                need_schedule = true;
+            } else if (policy == PolicyMLFQ && time_slice == config.mlfq_quanta[running.level]) {
+                running.level = min(running.level + 1, levels - 1);
+                ready_queue.push_back(running);
+                has_running = false;
+                need_schedule = true;
+            } else if (policy == PolicyDynamicPriority) {
+                if (running.priority > 1) running.priority--;
+                if (!ready_queue.empty() && ready_queue[0].priority >= running.priority) {
+                    ready_queue.push_back(running);
+                    has_running = false;
+                    need_schedule = true;
+                }
+            }
+        }
+        current_time++;
+    }
+    return result;
+}
+
+// 随机小负载：取值范围很窄，使键值相同、同时到达、阻塞中到达等情况频繁出现
+vector<RefProcess> RandomWorkload(mt19937& rng) {
+    uniform_int_distribution<int> count(1, 12), arrive(0, 15), service(1, 8), priority(1, 5), io_time(1, 5), coin(0, 2);
+    vector<RefProcess> processes(count(rng));
+    for (size_t i = 0; i < processes.size(); i++) {
+        RefProcess& pro = processes[i];
+        pro = RefProcess();
+        pro.ID = (int)i + 1;
+        pro.arrive_time = arrive(rng);
+        pro.service_time = service(rng);
+        pro.priority = priority(rng);
+        if (coin(rng) == 0) {
+            pro.io_start = -1;
+            pro.io_time = 0;
+        } else {
+            // 一到三次IO，按开始位置排列，可能在同一位置连续阻塞
+            vector<IoBurst> io(uniform_int_distribution<int>(1, 3)(rng));
+            for (IoBurst& burst : io) {
+                burst.start = uniform_int_distribution<int>(0, pro.service_time - 1)(rng);
+                burst.time = io_time(rng);
+            }
+            stable_sort(io.begin(), io.end(), [](const IoBurst& a, const IoBurst& b) { return a.start < b.start; });
+            pro.io_start = io[0].start;
+            pro.io_time = io[0].time;
+            pro.more_io.assign(io.begin() + 1, io.end());
+        }
+        pro.all_time = pro.service_time;
+        pro.start_time = pro.end_time = pro.response_time = -1;
+    }
+    return processes;
+}
+
+int failures = 0;
+
+void Fail(unsigned seed, int policy, const char* what) {
+    if (++failures <= 10) fprintf(stderr, "seed %u policy %d: %s\n", seed, policy, what);
+}
+
+void CheckEquivalence(unsigned seed) {
+    mt19937 rng(seed);
+    vector<RefProcess> workload = RandomWorkload(rng);
+    int quantum = uniform_int_distribution<int>(1, 6)(rng);
+    RefConfig config;
+    config.mlfq_quanta.resize(uniform_int_distribution<int>(1, 4)(rng));
+    for (int& q : config.mlfq_quanta) q = uniform_int_distribution<int>(1, 4)(rng);
+    config.mlfq_boost = uniform_int_distribution<int>(0, 1)(rng) ? uniform_int_distribution<int>(1, 20)(rng) : 0;
+    config.cfs_min_granularity = uniform_int_distribution<int>(1, 3)(rng);
+    config.cfs_latency = config.cfs_min_granularity * uniform_int_distribution<int>(1, 8)(rng);
+
+    // 最后一轮是换成随机时间片长度的时间片轮转
+    for (int run = PolicyFCFS; run <= kLastPolicy + 1; run++) {
+        int policy = run > kLastPolicy ? PolicyRoundRobin : run;
+        config.time_quantum = run > kLastPolicy ? quantum : 2;
+        RefResult expected = RunReference(workload, (SchedulePolicy)policy, config);
+
+        ProcessScheduler scheduler;
+        scheduler.quiet = true;
+        scheduler.time_quantum = config.time_quantum;
+        scheduler.mlfq_quanta = config.mlfq_quanta;
+        scheduler.mlfq_boost = config.mlfq_boost;
+        scheduler.cfs_latency = config.cfs_latency;
+        scheduler.cfs_min_granularity = config.cfs_min_granularity;
+        scheduler.pcb_pool.resize(workload.size());
+        for (size_t i = 0; i < workload.size(); i++) {
+            ProcessPCB& pro = scheduler.pcb_pool[i];
+            pro.arrive_time = workload[i].arrive_time;
+            pro.service_time = workload[i].service_time;
+            pro.priority = workload[i].priority;
+            pro.io_start = workload[i].io_start;
+            pro.io_time = workload[i].io_time;
+            pro.burst_offset = (uint32_t)scheduler.burst_arena.size();
+            pro.burst_count = (uint32_t)workload[i].more_io.size();
+            scheduler.burst_arena.insert(scheduler.burst_arena.end(), workload[i].more_io.begin(),
+                workload[i].more_io.end());
+            scheduler.InitProcess(pro, workload[i].ID);
+        }
+        scheduler.BuildArriveQueue(false);
+        scheduler.Simulate((SchedulePolicy)policy);
+
+        if (scheduler.finish_queue.size() != expected.finished.size()) {
+            Fail(seed, policy, "finished count differs");
+            continue;
+        }
+        for (size_t i = 0; i < expected.finished.size(); i++) {
+            const RefProcess& want = expected.finished[i];
+            const ProcessPCB& got = scheduler.Pcb(scheduler.finish_queue[i]);
+            if (got.ID != want.ID) {
+                Fail(seed, policy, "finish order differs");
+                break;
+            }
+            if (got.start_time != want.start_time || got.end_time != want.end_time ||
+                got.wait_time != want.wait_time || got.response_time != want.response_time ||
+                got.turnaround_time != want.turnaround_time || got.priority != want.priority) {
+                Fail(seed, policy, "process fields differ");
+                break;
+            }
+        }
+
+        vector<pair<int, int>> gantt;
+        for (const TimelineSegment& seg : scheduler.timelines[0].Segments()) {
+            if (seg.pid == kIdlePid) continue;
+            for (long long t = seg.start; t < seg.end; t++) gantt.push_back(make_pair(seg.pid, (int)t));
+        }
+        if (gantt != expected.gantt) Fail(seed, policy, "gantt differs");
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    unsigned runs = argc > 1 ? (unsigned)strtoul(argv[1], nullptr, 10) : 2000;
+    for (unsigned seed = 1; seed <= runs; seed++) CheckEquivalence(seed);
+    if (failures) {
+        fprintf(stderr, "%d mismatches\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("engine matches tick loop on %u workloads x 8 policies (+ Round-Robin with a random quantum)\n", runs);
+    return EXIT_SUCCESS;
+}
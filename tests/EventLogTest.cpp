@@ -0,0 +1,90 @@
+// EventLogTest.cpp
+// 事件日志的测试：很小的环形缓冲区（频繁回绕、模拟线程等待后台线程）记录的事件与大缓冲区完全相同；
+// 写入文件后读回与内存中的记录一致；完成事件与完成队列一一对应，时间等于结束时间。
+#include "../EventLog.h"
+#include "../ProcessSchedulingSimulator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+int failures = 0;
+
+void Check(bool ok, const char* what) {
+    if (!ok && ++failures <= 10) fprintf(stderr, "%s\n", what);
+}
+
+bool SameRecords(const EventRecord* a, const EventRecord* b, size_t count) {
+    return count == 0 || memcmp(a, b, count * sizeof(EventRecord)) == 0;
+}
+
+vector<EventRecord> Record(const string& spec, SchedulePolicy policy, size_t capacity) {
+    ProcessScheduler scheduler;
+    scheduler.quiet = true;
+    scheduler.ConfigureCpus(2, true, 0, true);
+    scheduler.LoadWorkload(spec);
+    EventLog log(EventLevelTrace, capacity);
+    log.Start(policy, scheduler.cpu_count);
+    scheduler.event_log = &log;
+    scheduler.Simulate(policy);
+    log.Stop();
+
+    map<int, int> end_time;
+    for (PcbHandle h : scheduler.finish_queue) end_time[scheduler.Pcb(h).ID] = scheduler.Pcb(h).end_time;
+    size_t finished = 0;
+    for (const EventRecord& rec : log.Records()) {
+        if (rec.type != EventFinish) continue;
+        finished++;
+        Check(end_time.count(rec.pid) && end_time[rec.pid] == rec.time, "finish event time differs from end time");
+    }
+    Check(finished == scheduler.finish_queue.size(), "finish events differ from the finish queue");
+    return log.Records();
+}
+
+void CheckFile(const string& spec, const vector<EventRecord>& expected) {
+    const string path = "event_log_test.bin";
+    ProcessScheduler scheduler;
+    scheduler.quiet = true;
+    scheduler.ConfigureCpus(2, true, 0, true);
+    scheduler.LoadWorkload(spec);
+    EventLog log(EventLevelTrace, 16);
+    wstring error;
+    Check(log.Start(PolicyRoundRobin, scheduler.cpu_count, path, error), "cannot create the event file");
+    scheduler.event_log = &log;
+    scheduler.Simulate(PolicyRoundRobin);
+    log.Stop();
+
+    EventLogReader reader;
+    Check(reader.Open(path), "cannot read the event file back");
+    Check(reader.Header().policy == PolicyRoundRobin && reader.Header().cpus == 2, "event file header differs");
+    Check(reader.Count() == expected.size() && SameRecords(reader.Records(), expected.data(), expected.size()),
+        "event file differs from the in-memory log");
+    remove(path.c_str());
+}
+
+} // namespace
+
+int main() {
+    for (unsigned seed = 1; seed <= 10; seed++) {
+        string spec = "gen:count=500,rate=0.4,io=0.3,seed=" + to_string(seed);
+        for (int p = PolicyFCFS; p <= kLastPolicy; p++) {
+            vector<EventRecord> large = Record(spec, (SchedulePolicy)p, 1 << 16);
+            vector<EventRecord> small = Record(spec, (SchedulePolicy)p, 8);
+            Check(large.size() == small.size() && SameRecords(large.data(), small.data(), large.size()),
+                "small ring buffer lost or reordered events");
+            if (p == PolicyRoundRobin) CheckFile(spec, large);
+        }
+    }
+    if (failures) {
+        fprintf(stderr, "%d failures\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("event log records match across buffer sizes and files\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+// GanttRenderTest.cpp
+// 甘特图布局的测试：每个运行段的起始像素列都被矩形或密度带覆盖（聚合不丢失运行时间），
+// 每行的图元数不超过像素宽度的两倍（与段数无关）；按进程分泳道时检查段所属进程的行。
+#include "../GanttRender.h"
+#include "../ProcessSchedulingSimulator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+int failures = 0;
+
+void Check(bool ok, const char* what) {
+    if (!ok && ++failures <= 10) fprintf(stderr, "%s\n", what);
+}
+
+// 场景中各行（按上边界）被覆盖的像素列
+map<int, vector<bool>> CoveredColumns(const GanttScene& scene, int left, int chart_width) {
+    map<int, vector<bool>> rows;
+    for (const GanttRect& r : scene.rects) {
+        if (r.x1 < left || r.x1 >= left + chart_width) continue;  // 图例
+        vector<bool>& row = rows[r.y1];
+        row.resize(chart_width, false);
+        for (int x = r.x1; x < r.x2 && x < left + chart_width; x++) row[x - left] = true;
+    }
+    return rows;
+}
+
+void CheckLayout(unsigned seed, int cpus, bool per_process) {
+    ProcessScheduler scheduler;
+    scheduler.quiet = true;
+    scheduler.ConfigureCpus(cpus, true, 0, true);
+    scheduler.LoadWorkload("gen:count=" + to_string(per_process ? 40 : 3000) + ",rate=0.6,io=0.2,seed=" + to_string(seed));
+    scheduler.Simulate(PolicyRoundRobin);
+
+    GanttOptions options;
+    options.width = 600;
+    options.per_process = per_process;
+    GanttRenderer renderer(scheduler.timelines, scheduler.pcb_pool);
+    GanttScene scene = renderer.Layout(options);
+
+    const int left = 70;
+    const bool legend = !per_process && scheduler.pcb_pool.size() <= options.legend_limit;
+    const int chart_width = options.width - left - (legend ? 120 : 20);
+    long long max_time = 1;
+    for (const Timeline& lane : scheduler.timelines) max_time = max(max_time, lane.EndTime());
+    double scale = (double)chart_width / max_time;
+
+    map<int, vector<bool>> covered = CoveredColumns(scene, left, chart_width);
+    vector<int> row_tops;
+    for (const auto& row : covered) row_tops.push_back(row.first);
+
+    map<int, size_t> row_of_pid;
+    for (size_t i = 0; i < scheduler.pcb_pool.size(); i++) row_of_pid[scheduler.pcb_pool[i].ID] = 0;
+    size_t index = 0;
+    for (auto& entry : row_of_pid) entry.second = index++;
+
+    for (size_t lane = 0; lane < scheduler.timelines.size(); lane++) {
+        for (const TimelineSegment& seg : scheduler.timelines[lane].Segments()) {
+            if (seg.pid == kIdlePid) continue;
+            size_t row = per_process ? row_of_pid[seg.pid] : lane;
+            if (row >= row_tops.size()) {
+                Check(false, "a lane with running segments has no rectangles");
+                continue;
+            }
+            int col = min((int)(seg.start * scale), chart_width - 1);
+            Check(covered[row_tops[row]][col], "running segment not covered by any rectangle or band");
+        }
+    }
+
+    map<int, size_t> per_row;
+    for (const GanttRect& r : scene.rects) per_row[r.y1]++;
+    for (const auto& row : per_row) Check(row.second <= (size_t)chart_width * 2, "row has more primitives than pixels");
+}
+
+} // namespace
+
+int main() {
+    for (unsigned seed = 1; seed <= 10; seed++) {
+        CheckLayout(seed, 1, false);
+        CheckLayout(seed, 4, false);
+        CheckLayout(seed, 2, true);
+    }
+    if (failures) {
+        fprintf(stderr, "%d failures\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("gantt layout covers every running segment with bounded primitives\n");
+    return EXIT_SUCCESS;
+}
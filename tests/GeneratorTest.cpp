@@ -0,0 +1,89 @@
+// GeneratorTest.cpp
+// 合成负载的测试：同一种子用1个线程和多个线程生成的进程与IO逐项相同，且已按到达时间排列；
+// 追加到已有内容之后时，后续IO的偏移指向追加的部分。
+#include "../WorkloadGenerator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+int failures = 0;
+
+void Check(bool ok, const string& what) {
+    if (!ok && ++failures <= 10) fprintf(stderr, "%s\n", what.c_str());
+}
+
+bool SameProcess(const ProcessPCB& a, const ProcessPCB& b) {
+    return a.arrive_time == b.arrive_time && a.service_time == b.service_time && a.priority == b.priority &&
+        a.io_start == b.io_start && a.io_time == b.io_time &&
+        a.burst_offset == b.burst_offset && a.burst_count == b.burst_count;
+}
+
+bool SameBurst(const IoBurst& a, const IoBurst& b) {
+    return a.start == b.start && a.time == b.time;
+}
+
+// 进程数跨越多个块，各块由不同线程生成
+void CheckThreads(const string& spec) {
+    GeneratorConfig config;
+    wstring error;
+    Check(WorkloadGenerator::ParseSpec(spec, config, error), spec + ": spec rejected");
+    vector<ProcessPCB> serial, parallel;
+    vector<IoBurst> serial_bursts, parallel_bursts;
+    config.threads = 1;
+    Check(WorkloadGenerator(config).Generate(serial, serial_bursts, error), spec + ": single-threaded generation failed");
+    for (int threads : { 2, 3, 8 }) {
+        string name = spec + " threads " + to_string(threads);
+        config.threads = threads;
+        parallel.clear();
+        parallel_bursts.clear();
+        Check(WorkloadGenerator(config).Generate(parallel, parallel_bursts, error), name + ": generation failed");
+        bool same = parallel.size() == serial.size() && parallel_bursts.size() == serial_bursts.size();
+        for (size_t i = 0; i < serial.size() && same; i++) same = SameProcess(serial[i], parallel[i]);
+        for (size_t i = 0; i < serial_bursts.size() && same; i++) same = SameBurst(serial_bursts[i], parallel_bursts[i]);
+        Check(same, name + ": workload depends on the thread count");
+    }
+    bool sorted = true;
+    for (size_t i = 1; i < serial.size(); i++) sorted = sorted && serial[i - 1].arrive_time <= serial[i].arrive_time;
+    Check(sorted, spec + ": processes not in arrival order");
+}
+
+// 第二次生成追加在第一次之后，后续IO与单独生成时相同
+void CheckAppend() {
+    GeneratorConfig config;
+    wstring error;
+    WorkloadGenerator::ParseSpec("gen:count=1000,io=0.5,io_bursts=3,seed=5", config, error);
+    vector<ProcessPCB> alone, appended;
+    vector<IoBurst> alone_bursts, appended_bursts;
+    WorkloadGenerator(config).Generate(alone, alone_bursts, error);
+    WorkloadGenerator(config).Generate(appended, appended_bursts, error);
+    WorkloadGenerator(config).Generate(appended, appended_bursts, error);
+    bool same = appended.size() == 2 * alone.size() && appended_bursts.size() == 2 * alone_bursts.size();
+    for (size_t i = 0; i < alone.size() && same; i++) {
+        const ProcessPCB& a = alone[i];
+        const ProcessPCB& b = appended[alone.size() + i];
+        same = a.burst_count == b.burst_count && b.burst_offset == a.burst_offset + alone_bursts.size();
+        for (uint32_t k = 0; k < a.burst_count && same; k++)
+            same = SameBurst(alone_bursts[a.burst_offset + k], appended_bursts[b.burst_offset + k]);
+    }
+    Check(same, "appended workload has wrong IO offsets");
+}
+
+} // namespace
+
+int main() {
+    CheckThreads("gen:count=300000,seed=11");
+    CheckThreads("gen:count=200000,arrival=bursty,service=pareto,io=0.4,io_bursts=3,priority=1:2:4,seed=3");
+    CheckThreads("gen:count=70000,service=bimodal,io=1,seed=8");
+    CheckAppend();
+    if (failures) {
+        fprintf(stderr, "%d failures\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("generated workloads are independent of the thread count\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+// OnlineTest.cpp
+// 在线调度的测试：多生产者队列不丢失、不重复且保持各生产者的顺序；
+// 不与墙上时间同步且开始前已提交全部进程时，结果与离线模拟完全相同；
+// 按速率并发提交时所有进程都完成并计入决策延迟；逐行读取时跳过表头和错误行，多次IO的进程保留全部IO。
+#include "../ProcessSchedulingSimulator.h"
+#include "../OnlineScheduler.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+int failures = 0;
+
+void Check(bool ok, const string& what) {
+    if (!ok && ++failures <= 10) fprintf(stderr, "%s\n", what.c_str());
+}
+
+// 4个生产者各推入10万个带序号的元素，容量较小以覆盖队列满时的等待
+void CheckQueue() {
+    const int producers = 4;
+    const uint64_t per_producer = 100000;
+    MpscQueue<uint64_t> queue(1000);
+    Check(queue.Capacity() == 1024, "capacity is not rounded up to a power of two");
+    vector<thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, p, per_producer]() {
+            for (uint64_t i = 0; i < per_producer; i++) {
+                uint64_t item = (uint64_t)p << 32 | i;
+                while (!queue.TryPush(item)) this_thread::yield();
+            }
+        });
+    }
+    vector<uint64_t> next(producers, 0);
+    uint64_t received = 0, item;
+    bool ordered = true;
+    while (received < producers * per_producer) {
+        if (!queue.TryPop(item)) continue;
+        int p = (int)(item >> 32);
+        ordered = ordered && p < producers && (item & 0xFFFFFFFFu) == next[p];
+        if (p < producers) next[p]++;
+        received++;
+    }
+    for (thread& t : threads) t.join();
+    Check(ordered, "items lost, duplicated or reordered within a producer");
+    Check(!queue.TryPop(item), "queue not empty after all items were received");
+}
+
+bool SameProcess(const ProcessPCB& a, const ProcessPCB& b) {
+    return a.ID == b.ID && a.arrive_time == b.arrive_time && a.service_time == b.service_time &&
+        a.priority == b.priority && a.start_time == b.start_time && a.end_time == b.end_time &&
+        a.wait_time == b.wait_time && a.response_time == b.response_time && a.io_count == b.io_count;
+}
+
+OnlineArrival ArrivalOf(const ProcessScheduler& workload, const ProcessPCB& pro) {
+    OnlineArrival arrival;
+    arrival.pcb.name = pro.name;
+    arrival.pcb.arrive_time = pro.arrive_time;
+    arrival.pcb.service_time = pro.service_time;
+    arrival.pcb.priority = pro.priority;
+    arrival.pcb.io_start = pro.io_start;
+    arrival.pcb.io_time = pro.io_time;
+    arrival.bursts.assign(workload.burst_arena.begin() + pro.burst_offset,
+        workload.burst_arena.begin() + pro.burst_offset + pro.burst_count);
+    return arrival;
+}
+
+// 全部进程在引擎开始前提交、不与墙上时间同步时，与离线模拟逐项相同
+void CheckOffline(const string& spec, int cpus) {
+    for (int p = PolicyFCFS; p <= kLastPolicy; p++) {
+        string name = spec + " cpus " + to_string(cpus) + " policy " + to_string(p);
+        ProcessScheduler offline;
+        offline.quiet = true;
+        offline.ConfigureCpus(cpus, cpus > 1, cpus > 1 ? 4 : 0, cpus > 1);
+        offline.LoadWorkload(spec);
+        ProcessScheduler engine = offline;
+        engine.RebindQueues();
+
+        OnlineScheduler online(engine, (SchedulePolicy)p, 0, offline.arrive_queue.size());
+        for (PcbHandle h : offline.arrive_queue) {
+            OnlineArrival arrival = ArrivalOf(offline, offline.Pcb(h));
+            online.Submit(arrival);
+        }
+        offline.Simulate((SchedulePolicy)p);
+        online.Run(nullptr, 0);
+
+        bool same = engine.finish_queue.size() == offline.finish_queue.size() &&
+            engine.current_time == offline.current_time && engine.timelines.size() == offline.timelines.size();
+        for (size_t i = 0; i < offline.finish_queue.size() && same; i++)
+            same = SameProcess(engine.Pcb(engine.finish_queue[i]), offline.Pcb(offline.finish_queue[i]));
+        for (size_t c = 0; c < offline.timelines.size() && same; c++) {
+            const vector<TimelineSegment>& a = engine.timelines[c].Segments();
+            const vector<TimelineSegment>& b = offline.timelines[c].Segments();
+            same = a.size() == b.size();
+            for (size_t i = 0; i < a.size() && same; i++)
+                same = a[i].pid == b[i].pid && a[i].start == b[i].start && a[i].end == b[i].end;
+        }
+        Check(same, name + ": online result differs from the offline simulation");
+        Check(online.Latency().Count() == (long long)offline.finish_queue.size(), name + ": decisions not counted");
+    }
+}
+
+// 两个生产者按速率并发提交，模拟时钟与墙上时间同步
+void CheckPaced() {
+    ProcessScheduler workload;
+    workload.quiet = true;
+    workload.LoadWorkload("gen:count=20000,rate=2,io=0.3,io_bursts=2,seed=9");
+    vector<ProcessPCB> processes;
+    for (PcbHandle h : workload.arrive_queue) processes.push_back(workload.Pcb(h));
+
+    ProcessScheduler engine;
+    engine.quiet = true;
+    engine.ConfigureCpus(4, true, 8, true);
+    OnlineScheduler online(engine, PolicyRoundRobin, 1000, 1024);
+    vector<thread> producers;
+    for (size_t i = 0; i < 2; i++) {
+        online.AddProducer();
+        producers.emplace_back([&, i]() {
+            ProduceGenerated(online, processes, workload.burst_arena, i, 2, 100000);
+            online.RemoveProducer();
+        });
+    }
+    long long reports = 0;
+    online.Run([&reports](const OnlineStatus&) { reports++; }, 0.02);
+    for (thread& t : producers) t.join();
+
+    Check(engine.pcb_pool.size() == processes.size(), "paced run lost arrivals");
+    Check(engine.finish_queue.size() == processes.size(), "paced run did not finish every process");
+    Check(online.Latency().Count() == (long long)processes.size(), "decision latency not recorded for every arrival");
+    Check(reports >= 2, "status was not published while running");
+    long long cpu_time = 0, service = 0;
+    bool ordered = true;
+    for (const ProcessPCB& pro : engine.pcb_pool) {
+        ordered = ordered && pro.start_time >= pro.arrive_time && pro.end_time > pro.start_time;
+        cpu_time += pro.cpu_time;
+        service += pro.service_time;
+    }
+    Check(ordered, "a process started before it arrived");
+    Check(cpu_time == service, "CPU time does not add up to the service time");
+}
+
+// 逐行读取：表头跳过，错误行计数后继续，多次IO的进程完整提交
+void CheckStream() {
+    FILE* fp = tmpfile();
+    fputs("name,arrive,service,priority,io_start,io_time\n"
+          "A,0,5,1,-1,0\n"
+          "broken line\n"
+          "C,3,6,2,0,0,1:2:2:3:3\n", fp);
+    rewind(fp);
+    ProcessScheduler engine;
+    engine.quiet = true;
+    engine.ConfigureCpus(1, false, 0, false);
+    OnlineScheduler online(engine, PolicyFCFS, 0);
+    ProduceStream(online, fp);
+    fclose(fp);
+    online.Run(nullptr, 0);
+
+    Check(online.Invalid() == 1, "invalid line not counted");
+    Check(engine.finish_queue.size() == 2, "stream processes not all finished");
+    bool found = false;
+    for (const ProcessPCB& pro : engine.pcb_pool) {
+        if (pro.name != L"C") continue;
+        found = true;
+        Check(pro.io_count == 2 && pro.burst_count == 1 && pro.cpu_time == 6, "multi-burst process lost its IO");
+    }
+    Check(found, "multi-burst process missing");
+}
+
+} // namespace
+
+int main() {
+    CheckQueue();
+    for (unsigned seed = 1; seed <= 3; seed++) {
+        string spec = "gen:count=400,rate=0.6,io=0.4,io_bursts=2,priority=1:2:4,seed=" + to_string(seed);
+        CheckOffline(spec, 1);
+        CheckOffline(spec, 3);
+    }
+    CheckPaced();
+    CheckStream();
+    if (failures) {
+        fprintf(stderr, "%d failures\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("online scheduling matches the offline simulation and every arrival is decided\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+// ReplicationTest.cpp
+// 重复实验的测试：Welford累计与两遍公式一致；结果与线程数无关；
+// 每次重复的结果与单独生成该种子的负载再模拟得到的相同。
+#include "../Replication.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+int failures = 0;
+
+void Check(bool ok, const char* what) {
+    if (!ok && ++failures <= 10) fprintf(stderr, "%s\n", what);
+}
+
+bool Near(double a, double b) {
+    return fabs(a - b) <= 1e-9 * (1 + fabs(a) + fabs(b));
+}
+
+void CheckRunningStat() {
+    mt19937 rng(7);
+    normal_distribution<double> sample(1e6, 3.0);  // 均值远大于标准差，朴素的平方和公式会丢精度
+    vector<double> xs(1000);
+    RunningStat stat;
+    for (double& x : xs) {
+        x = sample(rng);
+        stat.Add(x);
+    }
+    double mean = 0, m2 = 0;
+    for (double x : xs) mean += x;
+    mean /= xs.size();
+    for (double x : xs) m2 += (x - mean) * (x - mean);
+    Check(Near(stat.Mean(), mean), "Welford mean differs from two-pass mean");
+    Check(Near(stat.Stddev(), sqrt(m2 / (xs.size() - 1))), "Welford stddev differs from two-pass stddev");
+    Check(fabs(stat.HalfWidth95() * sqrt(1000.0) / stat.Stddev() - 1.9623) < 1e-3, "95% half width should use t(999)");
+
+    RunningStat pair;
+    pair.Add(1);
+    pair.Add(3);
+    Check(Near(pair.HalfWidth95(), 12.706), "95% half width for two samples should use t(1)");
+}
+
+bool SameStat(const RunningStat& a, const RunningStat& b) {
+    return a.Count() == b.Count() && a.Mean() == b.Mean() && a.Stddev() == b.Stddev();
+}
+
+void CheckReplications() {
+    GeneratorConfig config;
+    wstring error;
+    Check(WorkloadGenerator::ParseSpec("gen:count=300,seed=11,rate=0.8,io=0.3", config, error), "spec rejected");
+    ProcessScheduler settings;
+    settings.ConfigureCpus(2, true, 4, true);
+    vector<int> policies = { 1, 2, 3, 4, 5, 6 };
+
+    vector<ReplicationSummary> serial, parallel;
+    ReplicationRunner runner(config, settings);
+    Check(runner.Run(40, policies, 1, serial) == 0, "no replication should be skipped");
+    runner.Run(40, policies, 4, parallel);
+    for (size_t i = 0; i < policies.size(); i++) {
+        Check(SameStat(serial[i].wait, parallel[i].wait) && SameStat(serial[i].turnaround, parallel[i].turnaround) &&
+            SameStat(serial[i].weighted, parallel[i].weighted) && SameStat(serial[i].response, parallel[i].response),
+            "result depends on the number of threads");
+        Check(serial[i].wait.Count() == 40, "every replication should be counted");
+        Check(serial[i].pooled.Count() == parallel[i].pooled.Count() &&
+            serial[i].pooled.turnaround.Quantile(0.99) == parallel[i].pooled.turnaround.Quantile(0.99),
+            "pooled quantiles depend on the number of threads");
+    }
+
+    // 只做一次重复时，均值就是第0个种子的负载直接模拟的结果
+    vector<ReplicationSummary> single;
+    runner.Run(1, policies, 1, single);
+    for (size_t i = 0; i < policies.size(); i++) {
+        GeneratorConfig one = config;
+        one.seed = ReplicationRunner::ReplicationSeed(config.seed, 0);
+        ProcessScheduler scheduler;
+        scheduler.quiet = true;
+        scheduler.ConfigureCpus(2, true, 4, true);
+        wstring error;
+        WorkloadGenerator(one).Generate(scheduler.pcb_pool, scheduler.burst_arena, error);
+        for (size_t p = 0; p < scheduler.pcb_pool.size(); p++) scheduler.InitProcess(scheduler.pcb_pool[p], (int)p + 1);
+        scheduler.BuildArriveQueue(true);
+        scheduler.Simulate((SchedulePolicy)policies[i]);
+        ScheduleStatistics stats = scheduler.ComputeStatistics();
+        Check(single[i].wait.Mean() == stats.avg_wait && single[i].response.Mean() == stats.avg_response,
+            "replication differs from a direct simulation of the same seed");
+    }
+}
+
+} // namespace
+
+int main() {
+    CheckRunningStat();
+    CheckReplications();
+    if (failures) {
+        fprintf(stderr, "%d failures\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("replication statistics are exact and independent of thread count\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+// ResultCacheTest.cpp
+// 结果缓存的测试：存入后读回的完成进程、统计和甘特图与模拟结果完全相同；
+// 负载或所选算法的参数改变时键随之改变，其他算法的参数不影响键；
+// 条目被改动后读取失败并被删除；超出容量时淘汰最久未使用的条目。
+#include "../ProcessSchedulingSimulator.h"
+#include "../ResultCache.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+const char kDirectory[] = "result_cache_test";
+
+int failures = 0;
+
+void Check(bool ok, const string& what) {
+    if (!ok && ++failures <= 10) fprintf(stderr, "%s\n", what.c_str());
+}
+
+void Load(ProcessScheduler& scheduler, const string& spec, int cpus) {
+    scheduler.quiet = true;
+    scheduler.ConfigureCpus(cpus, cpus > 1, cpus > 1 ? 4 : 0, cpus > 1);
+    scheduler.LoadWorkload(spec);
+}
+
+bool SameProcess(const ProcessPCB& a, const ProcessPCB& b) {
+    return a.ID == b.ID && a.name == b.name && a.arrive_time == b.arrive_time && a.service_time == b.service_time &&
+        a.priority == b.priority && a.base_priority == b.base_priority && a.start_time == b.start_time &&
+        a.end_time == b.end_time && a.wait_time == b.wait_time && a.response_time == b.response_time &&
+        a.turnaround_time == b.turnaround_time && a.io_count == b.io_count && a.fair_share == b.fair_share &&
+        a.state == b.state;
+}
+
+void CheckSame(const ProcessScheduler& got, const ProcessScheduler& want, const string& what) {
+    bool same = got.finish_queue.size() == want.finish_queue.size() && got.current_time == want.current_time &&
+        got.policy == want.policy && got.timelines.size() == want.timelines.size();
+    for (size_t i = 0; i < want.finish_queue.size() && same; i++)
+        same = SameProcess(got.Pcb(got.finish_queue[i]), want.Pcb(want.finish_queue[i]));
+    for (size_t c = 0; c < want.timelines.size() && same; c++) {
+        const vector<TimelineSegment>& a = got.timelines[c].Segments();
+        const vector<TimelineSegment>& b = want.timelines[c].Segments();
+        same = a.size() == b.size();
+        for (size_t i = 0; i < a.size() && same; i++)
+            same = a[i].pid == b[i].pid && a[i].start == b[i].start && a[i].end == b[i].end;
+    }
+    ScheduleStatistics x = got.ComputeStatistics(), y = want.ComputeStatistics();
+    same = same && x.avg_wait == y.avg_wait && x.avg_turnaround == y.avg_turnaround &&
+        x.avg_weighted == y.avg_weighted && x.avg_response == y.avg_response &&
+        got.finish_stats.all.wait.Quantile(0.99) == want.finish_stats.all.wait.Quantile(0.99) &&
+        got.finish_stats.by_priority.size() == want.finish_stats.by_priority.size();
+    Check(same, what);
+}
+
+string EntryPath(const ResultKey& key) {
+    return (fs::path(kDirectory) / (key.Hex() + ".result")).string();
+}
+
+// 存入后读回与模拟结果相同
+void CheckRoundTrip(const string& spec, int cpus) {
+    for (int p = PolicyFCFS; p <= kLastPolicy; p++) {
+        string name = spec + " cpus " + to_string(cpus) + " policy " + to_string(p);
+        ProcessScheduler simulated;
+        Load(simulated, spec, cpus);
+        ResultKey key = ResultCache::Key(simulated, (SchedulePolicy)p);
+        simulated.Simulate((SchedulePolicy)p);
+        ResultCache cache(kDirectory, 1ULL << 30);
+        Check(cache.Store(key, simulated), name + ": store failed");
+
+        ProcessScheduler cached;
+        Load(cached, spec, cpus);
+        Check(ResultCache::Key(cached, (SchedulePolicy)p) == key, name + ": same workload gives a different key");
+        Check(cache.Load(key, cached), name + ": stored entry missing");
+        CheckSame(cached, simulated, name + ": cached result differs from the simulation");
+    }
+}
+
+void CheckKeys() {
+    const string spec = "gen:count=200,rate=0.5,io=0.3,seed=3";
+    ProcessScheduler base;
+    Load(base, spec, 2);
+    ProcessScheduler quantum;
+    Load(quantum, spec, 2);
+    quantum.time_quantum = 5;
+    Check(!(ResultCache::Key(base, PolicyRoundRobin) == ResultCache::Key(quantum, PolicyRoundRobin)),
+        "quantum does not change the Round-Robin key");
+    Check(ResultCache::Key(base, PolicyFCFS) == ResultCache::Key(quantum, PolicyFCFS), "quantum changes the FCFS key");
+    Check(!(ResultCache::Key(base, PolicyFCFS) == ResultCache::Key(base, PolicySJF)), "policy does not change the key");
+
+    ProcessScheduler service;
+    Load(service, spec, 2);
+    service.Pcb(service.arrive_queue[100]).service_time++;
+    Check(!(ResultCache::Key(base, PolicyFCFS) == ResultCache::Key(service, PolicyFCFS)),
+        "service time does not change the key");
+    ProcessScheduler cpus;
+    Load(cpus, spec, 3);
+    Check(!(ResultCache::Key(base, PolicyFCFS) == ResultCache::Key(cpus, PolicyFCFS)), "CPU count does not change the key");
+}
+
+// 改动条目中的一个字节后读取失败，条目被删除
+void CheckCorruption() {
+    const string spec = "gen:count=300,rate=0.5,io=0.3,seed=5";
+    ProcessScheduler simulated;
+    Load(simulated, spec, 1);
+    ResultKey key = ResultCache::Key(simulated, PolicyRoundRobin);
+    simulated.Simulate(PolicyRoundRobin);
+    ResultCache cache(kDirectory, 1ULL << 30);
+    cache.Store(key, simulated);
+
+    string path = EntryPath(key);
+    uintmax_t size = fs::file_size(path);
+    {
+        fstream file(path, ios::in | ios::out | ios::binary);
+        file.seekg((streamoff)(size / 2));
+        char byte = 0;
+        file.read(&byte, 1);
+        byte ^= 0x10;
+        file.seekp((streamoff)(size / 2));
+        file.write(&byte, 1);
+    }
+    ProcessScheduler cached;
+    Load(cached, spec, 1);
+    Check(!cache.Load(key, cached) && !cache.Error().empty(), "corrupted entry was accepted");
+    Check(!fs::exists(path), "corrupted entry was not removed");
+    Check(cached.pcb_pool.size() == 300 && cached.finish_queue.empty(), "failed load changed the scheduler");
+
+    // 截断的条目同样拒绝
+    cache.Store(key, simulated);
+    fs::resize_file(path, size - 3);
+    Check(!cache.Load(key, cached), "truncated entry was accepted");
+}
+
+// 容量只够两个条目时，最近读取过的条目保留，最久未用的被淘汰
+void CheckEviction() {
+    fs::remove_all(kDirectory);
+    vector<ResultKey> keys;
+    vector<ProcessScheduler> results(3);
+    for (int i = 0; i < 3; i++) {
+        Load(results[i], "gen:count=500,rate=0.5,seed=" + to_string(10 + i), 1);
+        keys.push_back(ResultCache::Key(results[i], PolicyFCFS));
+        results[i].Simulate(PolicyFCFS);
+    }
+    ResultCache probe(kDirectory, 1ULL << 30);
+    probe.Store(keys[0], results[0]);
+    uintmax_t entry = fs::file_size(EntryPath(keys[0]));
+
+    ResultCache cache(kDirectory, entry * 5 / 2);
+    cache.Store(keys[1], results[1]);
+    // 两个条目的使用时间拨到过去，先存入的更旧；读取后它成为最近使用的
+    fs::file_time_type now = fs::file_time_type::clock::now();
+    fs::last_write_time(EntryPath(keys[0]), now - chrono::seconds(20));
+    fs::last_write_time(EntryPath(keys[1]), now - chrono::seconds(10));
+    ProcessScheduler used;
+    used.ConfigureCpus(1, false, 0, false);
+    Check(cache.Load(keys[0], used), "entry missing before eviction");
+    cache.Store(keys[2], results[2]);
+    Check(fs::exists(EntryPath(keys[0])), "recently used entry was evicted");
+    Check(!fs::exists(EntryPath(keys[1])), "least recently used entry was kept");
+    Check(fs::exists(EntryPath(keys[2])), "new entry was evicted");
+
+    ResultCache tiny(kDirectory, 64);
+    Check(!tiny.Store(keys[1], results[1]) && !fs::exists(EntryPath(keys[1])), "entry larger than the cache was stored");
+}
+
+} // namespace
+
+int main() {
+    fs::remove_all(kDirectory);
+    for (unsigned seed = 1; seed <= 5; seed++) {
+        string spec = "gen:count=400,rate=0.6,io=0.4,io_bursts=2,priority=1:2:4,seed=" + to_string(seed);
+        CheckRoundTrip(spec, 1);
+        CheckRoundTrip(spec, 3);
+    }
+    CheckKeys();
+    CheckCorruption();
+    CheckEviction();
+    fs::remove_all(kDirectory);
+    if (failures) {
+        fprintf(stderr, "%d failures\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("cached results match the simulations and damaged entries are rejected\n");
+    return EXIT_SUCCESS;
+}
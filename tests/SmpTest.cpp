@@ -0,0 +1,198 @@
+// SmpTest.cpp
+// 多CPU调度的不变量测试
+// 在随机的小负载上以各种CPU数、队列模式、均衡和窃取配置运行每个算法，检查：
+// 所有进程都完成；各进程在甘特图中的CPU时间之和等于服务时间；同一进程不会同时在两个CPU上运行；
+// 进程不早于到达时刻开始、不晚于第一段开始，最后一段的结束时刻等于完成时刻；
+// 没有IO时，全局队列和开启窃取的每CPU队列不会在有就绪进程时让CPU空闲，
+// 此时CFS按权重应得的CPU时间之和等于实际的忙碌时间。
+// 单CPU时每CPU队列的结果应与全局队列完全相同。
+#include "../ProcessSchedulingSimulator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct SmpConfig {
+    int cpus;
+    bool per_cpu;
+    int balance_interval;
+    bool stealing;
+};
+
+const SmpConfig kConfigs[] = {
+    { 1, true, 0, false },
+    { 2, false, 0, false },
+    { 2, true, 0, false },
+    { 2, true, 0, true },
+    { 3, true, 3, false },
+    { 4, false, 0, false },
+    { 4, true, 5, true },
+    { 8, true, 1, true },
+};
+
+struct Workload {
+    vector<int> arrive, service, priority, io_start, io_time;
+    size_t size() const { return arrive.size(); }
+};
+
+Workload RandomWorkload(mt19937& rng, bool with_io) {
+    uniform_int_distribution<int> count(1, 24), arrive(0, 20), service(1, 9), priority(1, 5), io_time(1, 6), coin(0, 2);
+    Workload w;
+    int n = count(rng);
+    for (int i = 0; i < n; i++) {
+        int s = service(rng);
+        w.arrive.push_back(arrive(rng));
+        w.service.push_back(s);
+        w.priority.push_back(priority(rng));
+        if (!with_io || coin(rng) == 0) {
+            w.io_start.push_back(-1);
+            w.io_time.push_back(0);
+        } else {
+            w.io_start.push_back(uniform_int_distribution<int>(0, s - 1)(rng));
+            w.io_time.push_back(io_time(rng));
+        }
+    }
+    return w;
+}
+
+void Simulate(ProcessScheduler& scheduler, const Workload& w, const SmpConfig& config, int policy) {
+    scheduler.quiet = true;
+    scheduler.ConfigureCpus(config.cpus, config.per_cpu, config.balance_interval, config.stealing);
+    scheduler.pcb_pool.resize(w.size());
+    for (size_t i = 0; i < w.size(); i++) {
+        ProcessPCB& pro = scheduler.pcb_pool[i];
+        pro.arrive_time = w.arrive[i];
+        pro.service_time = w.service[i];
+        pro.priority = w.priority[i];
+        pro.io_start = w.io_start[i];
+        pro.io_time = w.io_time[i];
+        scheduler.InitProcess(pro, (int)i + 1);
+    }
+    scheduler.BuildArriveQueue(false);
+    scheduler.Simulate((SchedulePolicy)policy);
+}
+
+int failures = 0;
+
+void Fail(unsigned seed, int config, int policy, const char* what) {
+    if (++failures <= 10) fprintf(stderr, "seed %u config %d policy %d: %s\n", seed, config, policy, what);
+}
+
+void CheckInvariants(unsigned seed, int k, int policy, const Workload& w, bool with_io) {
+    const SmpConfig& config = kConfigs[k];
+    ProcessScheduler scheduler;
+    Simulate(scheduler, w, config, policy);
+
+    if (scheduler.finish_queue.size() != w.size()) {
+        Fail(seed, k, policy, "not every process finished");
+        return;
+    }
+    if ((int)scheduler.timelines.size() != config.cpus) {
+        Fail(seed, k, policy, "one Gantt lane per CPU expected");
+        return;
+    }
+
+    // 按进程收集所有泳道上的运行段
+    map<int, vector<pair<long long, long long>>> runs;
+    for (const Timeline& lane : scheduler.timelines) {
+        for (const TimelineSegment& seg : lane.Segments()) {
+            if (seg.pid != kIdlePid) runs[seg.pid].push_back(make_pair(seg.start, seg.end));
+        }
+    }
+    for (PcbHandle h : scheduler.finish_queue) {
+        const ProcessPCB& pro = scheduler.Pcb(h);
+        vector<pair<long long, long long>>& spans = runs[pro.ID];
+        sort(spans.begin(), spans.end());
+        long long total = 0;
+        for (size_t i = 0; i < spans.size(); i++) {
+            total += spans[i].second - spans[i].first;
+            if (i > 0 && spans[i].first < spans[i - 1].second) {
+                Fail(seed, k, policy, "process runs on two CPUs at once");
+                return;
+            }
+        }
+        if (total != pro.service_time) {
+            Fail(seed, k, policy, "CPU time differs from service time");
+            return;
+        }
+        // io_start为0的进程调度后立即阻塞，start_time会早于第一段
+        if (pro.start_time < pro.arrive_time || pro.start_time > spans.front().first ||
+            pro.end_time != spans.back().second) {
+            Fail(seed, k, policy, "start or end time does not match the Gantt chart");
+            return;
+        }
+    }
+
+    // 不含IO时，已到达未完成的进程数即可运行的进程数
+    bool conserving = !config.per_cpu || config.stealing;
+    if (with_io || !conserving) return;
+    long long end = 0;
+    for (const Timeline& lane : scheduler.timelines) end = max(end, lane.EndTime());
+    for (long long t = 0; t < end; t++) {
+        int busy = 0, runnable = 0;
+        for (const Timeline& lane : scheduler.timelines) {
+            if (lane.RunningAt(t) != kIdlePid) busy++;
+        }
+        for (PcbHandle h : scheduler.finish_queue) {
+            const ProcessPCB& pro = scheduler.Pcb(h);
+            if (pro.arrive_time <= t && t < pro.end_time) runnable++;
+        }
+        if (busy != min(runnable, config.cpus)) {
+            Fail(seed, k, policy, "CPU idle while a process is ready");
+            return;
+        }
+    }
+    if (policy == PolicyCFS) {
+        double entitled = 0, used = 0;
+        for (PcbHandle h : scheduler.finish_queue) {
+            entitled += scheduler.Pcb(h).fair_share;
+            used += scheduler.Pcb(h).service_time;
+        }
+        if (fabs(entitled - used) > 1e-9 * used) Fail(seed, k, policy, "CFS entitled CPU time differs from busy time");
+    }
+}
+
+// 单CPU的每CPU队列与全局队列应得到相同的结果
+void CheckSingleCpu(unsigned seed, int policy, const Workload& w) {
+    ProcessScheduler shared, per_cpu;
+    Simulate(shared, w, SmpConfig{ 1, false, 0, false }, policy);
+    Simulate(per_cpu, w, kConfigs[0], policy);
+    bool same = shared.finish_queue == per_cpu.finish_queue;
+    for (size_t i = 0; same && i < shared.finish_queue.size(); i++) {
+        const ProcessPCB& a = shared.Pcb(shared.finish_queue[i]);
+        const ProcessPCB& b = per_cpu.Pcb(per_cpu.finish_queue[i]);
+        same = a.start_time == b.start_time && a.end_time == b.end_time && a.wait_time == b.wait_time;
+    }
+    if (!same) Fail(seed, 0, policy, "per-CPU queue on one CPU differs from the shared queue");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    unsigned runs = argc > 1 ? (unsigned)strtoul(argv[1], nullptr, 10) : 500;
+    for (unsigned seed = 1; seed <= runs; seed++) {
+        mt19937 rng(seed);
+        bool with_io = seed % 2 == 0;
+        Workload w = RandomWorkload(rng, with_io);
+        for (int policy = PolicyFCFS; policy <= kLastPolicy; policy++) {
+            CheckSingleCpu(seed, policy, w);
+            for (int k = 0; k < (int)(sizeof(kConfigs) / sizeof(kConfigs[0])); k++) {
+                CheckInvariants(seed, k, policy, w, with_io);
+            }
+        }
+    }
+    if (failures) {
+        fprintf(stderr, "%d invariant violations\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("SMP invariants hold on %u workloads x 8 policies x %d configurations\n",
+        runs, (int)(sizeof(kConfigs) / sizeof(kConfigs[0])));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+// SnapshotTest.cpp
+// 快照和分叉的测试：
+// 在随机时刻停下取快照、按原算法分叉后接着推进，结果与一次模拟到底完全相同
+// （完成顺序、各进程的时间字段、统计和甘特图）；从同一快照并行运行的各分支与逐个分叉的结果相同，快照不受影响；
+// 换用其他算法或参数时所有进程都完成，各进程的CPU时间之和等于服务时间，
+// 快照时刻之前的甘特图和已完成的进程与前段的模拟相同。
+#include "../ProcessSchedulingSimulator.h"
+#include "../Snapshot.h"
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct CpuConfig {
+    int cpus;
+    bool per_cpu;
+    int balance_interval;
+    bool stealing;
+};
+
+const CpuConfig kConfigs[] = {
+    { 1, false, 0, false },
+    { 2, true, 3, true },
+    { 3, false, 0, false },
+};
+
+int failures = 0;
+
+void Check(bool ok, const string& what) {
+    if (!ok && ++failures <= 10) fprintf(stderr, "%s\n", what.c_str());
+}
+
+void Load(ProcessScheduler& scheduler, const string& spec, const CpuConfig& config) {
+    scheduler.quiet = true;
+    scheduler.ConfigureCpus(config.cpus, config.per_cpu, config.balance_interval, config.stealing);
+    scheduler.LoadWorkload(spec);
+}
+
+// 各CPU在time之前每个时间单位运行的进程：(CPU, 时刻) -> 进程ID
+map<pair<int, long long>, int> TicksBefore(const ProcessScheduler& scheduler, long long time) {
+    map<pair<int, long long>, int> ticks;
+    for (size_t c = 0; c < scheduler.timelines.size(); c++) {
+        for (const TimelineSegment& seg : scheduler.timelines[c].Segments()) {
+            if (seg.pid == kIdlePid) continue;
+            for (long long t = seg.start; t < seg.end && t < time; t++) ticks[make_pair((int)c, t)] = seg.pid;
+        }
+    }
+    return ticks;
+}
+
+bool SameProcess(const ProcessPCB& a, const ProcessPCB& b) {
+    return a.ID == b.ID && a.start_time == b.start_time && a.end_time == b.end_time && a.wait_time == b.wait_time &&
+        a.response_time == b.response_time && a.turnaround_time == b.turnaround_time && a.priority == b.priority;
+}
+
+void CheckSame(const ProcessScheduler& got, const ProcessScheduler& want, const string& what) {
+    bool same = got.finish_queue.size() == want.finish_queue.size() && got.current_time == want.current_time;
+    for (size_t i = 0; i < want.finish_queue.size() && same; i++)
+        same = SameProcess(got.Pcb(got.finish_queue[i]), want.Pcb(want.finish_queue[i]));
+    for (size_t c = 0; c < want.timelines.size() && same; c++) {
+        const vector<TimelineSegment>& a = got.timelines[c].Segments();
+        const vector<TimelineSegment>& b = want.timelines[c].Segments();
+        same = a.size() == b.size();
+        for (size_t i = 0; i < a.size() && same; i++)
+            same = a[i].pid == b[i].pid && a[i].start == b[i].start && a[i].end == b[i].end;
+    }
+    ScheduleStatistics x = got.ComputeStatistics(), y = want.ComputeStatistics();
+    same = same && x.avg_wait == y.avg_wait && x.avg_turnaround == y.avg_turnaround && x.avg_response == y.avg_response;
+    Check(same, what);
+}
+
+// 换算法后的分支：全部完成，CPU时间等于服务时间，快照之前的部分与快照相同
+void CheckBranch(const ProcessScheduler& branch, const SimulationSnapshot& snapshot, const string& what) {
+    const ProcessScheduler& prefix = snapshot.State();
+    Check(branch.finish_queue.size() == branch.pcb_pool.size(), what + ": not every process finished");
+    map<int, long long> ran;
+    for (const Timeline& lane : branch.timelines) {
+        for (const TimelineSegment& seg : lane.Segments()) {
+            if (seg.pid != kIdlePid) ran[seg.pid] += seg.end - seg.start;
+        }
+    }
+    bool served = true;
+    for (const ProcessPCB& pro : branch.pcb_pool) served = served && ran[pro.ID] == pro.service_time;
+    Check(served, what + ": CPU time differs from service time");
+    Check(TicksBefore(branch, snapshot.Time()) == TicksBefore(prefix, snapshot.Time()),
+        what + ": gantt before the snapshot changed");
+    bool kept = true;
+    for (size_t i = 0; i < prefix.finish_queue.size() && kept; i++)
+        kept = SameProcess(branch.Pcb(branch.finish_queue[i]), prefix.Pcb(prefix.finish_queue[i]));
+    Check(kept, what + ": processes finished before the snapshot changed");
+}
+
+void CheckSeed(unsigned seed) {
+    mt19937 rng(seed);
+    string spec = "gen:count=150,rate=0.6,io=0.4,io_bursts=2,seed=" + to_string(seed);
+    for (const CpuConfig& config : kConfigs) {
+        for (int p = PolicyFCFS; p <= kLastPolicy; p++) {
+            string name = "seed " + to_string(seed) + " cpus " + to_string(config.cpus) + " policy " + to_string(p);
+            ProcessScheduler straight;
+            Load(straight, spec, config);
+            straight.Simulate((SchedulePolicy)p);
+
+            // 分段推进并从快照按原算法分叉
+            ProcessScheduler staged;
+            Load(staged, spec, config);
+            staged.Start((SchedulePolicy)p);
+            int time = uniform_int_distribution<int>(0, straight.current_time)(rng);
+            staged.RunUntil(time);
+            Check(staged.current_time == time, name + ": stopped at the wrong time");
+            SimulationSnapshot snapshot(staged);
+            ProcessScheduler forked;
+            snapshot.Fork(forked, SnapshotBranch{ (SchedulePolicy)p, &staged });
+            forked.RunUntil(LLONG_MAX);
+            CheckSame(forked, straight, name + ": same-policy fork differs from a straight run");
+            staged.RunUntil(LLONG_MAX);
+            CheckSame(staged, straight, name + ": staged run differs from a straight run");
+
+            // 移交给快照（不复制）的状态同样可以分叉
+            ProcessScheduler handed;
+            handed.CopyState(snapshot.State());
+            SimulationSnapshot taken(std::move(handed));
+            ProcessScheduler from_taken;
+            taken.Fork(from_taken, SnapshotBranch{ (SchedulePolicy)p, &taken.State() });
+            from_taken.RunUntil(LLONG_MAX);
+            CheckSame(from_taken, straight, name + ": fork of a handed-over snapshot differs from a straight run");
+
+            // 各算法并行接手，时间片和MLFQ参数也换掉
+            ProcessScheduler settings;
+            settings.time_quantum = 3;
+            settings.mlfq_quanta = { 1, 3 };
+            settings.mlfq_boost = 20;
+            vector<SnapshotBranch> branches;
+            for (int q = PolicyFCFS; q <= kLastPolicy; q++) branches.push_back(SnapshotBranch{ (SchedulePolicy)q, &settings });
+            vector<PolicyOutcome> outcomes;
+            snapshot.RunBranches(branches, 4, outcomes);
+            for (size_t i = 0; i < branches.size(); i++) {
+                ProcessScheduler branch;
+                snapshot.Fork(branch, branches[i]);
+                branch.RunUntil(LLONG_MAX);
+                string what = name + " -> " + to_string(branches[i].policy);
+                CheckBranch(branch, snapshot, what);
+                ScheduleStatistics stats = branch.ComputeStatistics();
+                Check(outcomes[i].end_time == branch.current_time && outcomes[i].stats.avg_wait == stats.avg_wait &&
+                    outcomes[i].stats.avg_response == stats.avg_response, what + ": parallel branch differs");
+            }
+            Check(snapshot.Time() == time && snapshot.State().finish_queue.size() <= straight.finish_queue.size(),
+                name + ": snapshot changed by its branches");
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    for (unsigned seed = 1; seed <= 30; seed++) CheckSeed(seed);
+    if (failures) {
+        fprintf(stderr, "%d failures\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("forks from snapshots match straight runs and keep the simulated prefix\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,107 @@
+// StatisticsTest.cpp
+// 流式统计的测试：HDR直方图的分位数与排序后精确分位数的相对误差不超过1/128；
+// 直方图和Welford累计器分块合并后与整体累计一致；调度器完成时记入的统计与遍历完成队列的结果一致。
+#include "../Statistics.h"
+#include "../ProcessSchedulingSimulator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+int failures = 0;
+
+void Check(bool ok, const char* what) {
+    if (!ok && ++failures <= 10) fprintf(stderr, "%s\n", what);
+}
+
+bool Near(double a, double b, double tolerance) {
+    return fabs(a - b) <= tolerance * (1 + fabs(a) + fabs(b));
+}
+
+void CheckHistogram(unsigned seed) {
+    mt19937_64 rng(seed);
+    // 跨越多个数量级的重尾样本
+    lognormal_distribution<double> sample(3.0, 2.5);
+    vector<uint64_t> values(20000);
+    HdrHistogram whole, first, second;
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = (uint64_t)sample(rng);
+        whole.Record(values[i]);
+        (i % 3 ? first : second).Record(values[i]);
+    }
+    first.Merge(second);
+    sort(values.begin(), values.end());
+
+    const double quantiles[] = { 0, 0.5, 0.9, 0.99, 0.999, 1 };
+    for (double q : quantiles) {
+        size_t rank = max<size_t>(1, (size_t)ceil(q * values.size()));
+        double exact = (double)values[rank - 1];
+        double got = (double)whole.ValueAtQuantile(q);
+        Check(got <= exact && exact - got <= exact / 128, "quantile outside the 1/128 error bound");
+        Check(first.ValueAtQuantile(q) == whole.ValueAtQuantile(q), "merged histogram differs from the whole");
+    }
+    Check(whole.ValueAtQuantile(0) == values.front() && whole.ValueAtQuantile(1) == values.back(),
+        "extreme quantiles should be the exact minimum and maximum");
+}
+
+void CheckMerge(unsigned seed) {
+    mt19937 rng(seed);
+    exponential_distribution<double> sample(0.01);
+    RunningStat whole, parts[4];
+    for (int i = 0; i < 5000; i++) {
+        double x = sample(rng);
+        whole.Add(x);
+        parts[rng() % 4].Add(x);
+    }
+    RunningStat merged;
+    for (const RunningStat& part : parts) merged.Merge(part);
+    Check(merged.Count() == whole.Count(), "merged count differs");
+    Check(Near(merged.Mean(), whole.Mean(), 1e-12), "merged mean differs");
+    Check(Near(merged.Stddev(), whole.Stddev(), 1e-9), "merged stddev differs");
+}
+
+void CheckScheduler(unsigned seed) {
+    ProcessScheduler scheduler;
+    scheduler.quiet = true;
+    scheduler.ConfigureCpus(2, true, 0, true);
+    scheduler.LoadWorkload("gen:count=3000,rate=0.4,io=0.2,priority=1:2:3,seed=" + to_string(seed));
+    scheduler.Simulate(PolicyDynamicPriority);
+
+    double wait = 0, weighted = 0;
+    size_t by_class[4] = { 0, 0, 0, 0 };
+    for (PcbHandle h : scheduler.finish_queue) {
+        const ProcessPCB& pro = scheduler.Pcb(h);
+        wait += pro.wait_time;
+        weighted += (double)pro.turnaround_time / pro.service_time;
+        if (pro.base_priority >= 1 && pro.base_priority <= 3) by_class[pro.base_priority]++;
+    }
+    ScheduleStatistics stats = scheduler.ComputeStatistics();
+    Check(stats.finished == scheduler.finish_queue.size(), "finished count differs");
+    Check(stats.avg_wait == wait / stats.finished, "average wait differs from the finish queue");
+    Check(stats.avg_weighted == weighted / stats.finished, "average weighted turnaround differs from the finish queue");
+    for (int p = 1; p <= 3; p++) {
+        Check((size_t)scheduler.finish_stats.by_priority[p].Count() == by_class[p], "priority class count differs");
+    }
+}
+
+} // namespace
+
+int main() {
+    for (unsigned seed = 1; seed <= 20; seed++) {
+        CheckHistogram(seed);
+        CheckMerge(seed);
+        CheckScheduler(seed);
+    }
+    if (failures) {
+        fprintf(stderr, "%d failures\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("streaming statistics match exact computations\n");
+    return EXIT_SUCCESS;
+}